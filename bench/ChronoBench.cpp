@@ -0,0 +1,43 @@
+#include <cstdint>
+
+#include "Bench.hpp"
+#include "Chrono.hpp"
+
+namespace {
+
+  // Start and stop pairs per iteration, divide the average to get the overhead of one
+  constexpr int SAMPLES = 1000;
+
+  volatile std::uint64_t sink;
+
+  template<typename Chrono>
+    void startStop() {
+      Chrono chrono;
+      std::uint64_t sum = 0;
+      for (int i = 0; i < SAMPLES; ++i) {
+        chrono.start();
+        chrono.stop();
+        sum += chrono.asTicks();
+      }
+      sink = sum;
+    }
+
+}
+
+UTL_BENCHMARK(chronoStartStop1k) {
+  startStop<utl::Chrono>();
+}
+
+UTL_BENCHMARK(tscChronoStartStop1k) {
+  startStop<utl::TscChrono>();
+}
+
+UTL_BENCHMARK(chronoStopHistogram1k) {
+  static utl::Histogram histogram;
+  utl::Chrono chrono;
+  for (int i = 0; i < SAMPLES; ++i) {
+    chrono.start();
+    chrono.stop(histogram);
+  }
+  sink = histogram.getTotalCount();
+}
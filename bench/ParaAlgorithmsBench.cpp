@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(UTL_BENCH_PARALLEL_STL)
+#include <execution>
+#endif
+
+#include "Bench.hpp"
+#include "ParaAlgorithms.hpp"
+#include "RandomNumberGenerator.hpp"
+
+namespace {
+
+  constexpr std::size_t SMALL = 1 << 18;
+  constexpr std::size_t LARGE = 10000000;
+  // Runs of every 10M benchmark, each one takes about a second on a single core
+  constexpr std::size_t LARGE_ITERATIONS = 3;
+
+  utl::ParaLooper& looper() {
+    static utl::ParaLooper pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+  }
+
+  template<std::size_t Size>
+    const std::vector<std::int64_t>& input() {
+      static const std::vector<std::int64_t> values = [] {
+        utl::IntegerNumberGenerator<std::int64_t> rng(42);
+        std::vector<std::int64_t> v(Size);
+        for (auto &x : v) {
+          x = rng.interval(INT64_MIN, INT64_MAX);
+        }
+        return v;
+      }();
+      return values;
+    }
+
+  // Keys over the whole int64 range, copying the input is part of every
+  // measure so that each run sorts the same data
+  std::vector<std::int64_t> values;
+  std::vector<std::int64_t> scratch;
+
+  bool isEven(const std::int64_t v) {
+    return v % 2 == 0;
+  }
+
+}
+
+UTL_BENCHMARK(stdSort256k) {
+  values = input<SMALL>();
+  std::sort(values.begin(), values.end());
+}
+
+UTL_BENCHMARK(stdStableSort256k) {
+  values = input<SMALL>();
+  std::stable_sort(values.begin(), values.end());
+}
+
+UTL_BENCHMARK(parallelSort256k) {
+  values = input<SMALL>();
+  utl::parallelSort(looper(), values.begin(), values.end(), scratch);
+}
+
+UTL_BENCHMARK(parallelRadixSort256k) {
+  values = input<SMALL>();
+  utl::parallelRadixSort(looper(), values.begin(), values.end(), scratch);
+}
+
+UTL_BENCHMARK(stdStablePartition256k) {
+  values = input<SMALL>();
+  std::stable_partition(values.begin(), values.end(), isEven);
+}
+
+UTL_BENCHMARK(parallelPartition256k) {
+  values = input<SMALL>();
+  utl::parallelPartition(looper(), values.begin(), values.end(), isEven, scratch);
+}
+
+UTL_BENCHMARK(parallelHistogram256k) {
+  static std::vector<std::size_t> counts(256);
+  utl::parallelHistogram(looper(), input<SMALL>().begin(), input<SMALL>().end(), [](const std::int64_t v) {
+    return static_cast<std::size_t>(v) & 0xff;
+  }, counts);
+}
+
+UTL_BENCHMARK_ITERATIONS(stdSort10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  std::sort(values.begin(), values.end());
+}
+
+UTL_BENCHMARK_ITERATIONS(parallelSort10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  utl::parallelSort(looper(), values.begin(), values.end(), scratch);
+}
+
+UTL_BENCHMARK_ITERATIONS(parallelRadixSort10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  utl::parallelRadixSort(looper(), values.begin(), values.end(), scratch);
+}
+
+UTL_BENCHMARK_ITERATIONS(parallelPartition10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  utl::parallelPartition(looper(), values.begin(), values.end(), isEven, scratch);
+}
+
+#if defined(UTL_BENCH_PARALLEL_STL)
+UTL_BENCHMARK_ITERATIONS(stdSortPar10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  std::sort(std::execution::par, values.begin(), values.end());
+}
+
+UTL_BENCHMARK_ITERATIONS(stdStableSortPar10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  std::stable_sort(std::execution::par, values.begin(), values.end());
+}
+
+UTL_BENCHMARK_ITERATIONS(stdStablePartitionPar10M, LARGE_ITERATIONS) {
+  values = input<LARGE>();
+  std::stable_partition(std::execution::par, values.begin(), values.end(), isEven);
+}
+#endif
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "ParaLooper.hpp"
+
+namespace {
+
+  utl::ParaLooper& looper() {
+    static utl::ParaLooper pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+  }
+
+  // Separate pool so that the background backlog doesn't leak into other benchmarks
+  utl::ParaLooper& loadedLooper() {
+    static utl::ParaLooper pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+  }
+
+  // Background tasks spin for about this long, the backlog is kept at BACKGROUND_BACKLOG tasks
+  constexpr auto BACKGROUND_TASK = std::chrono::microseconds(20);
+  constexpr std::size_t BACKGROUND_BACKLOG = 256;
+
+  void spin(const std::chrono::steady_clock::duration duration) {
+    const auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+
+  void awaitPosted(utl::ParaLooper& pool, const utl::ParaLooper::Priority priority) {
+    std::atomic<bool> done(false);
+    pool.post([&done] {
+      done.store(true, std::memory_order_release);
+    }, priority);
+    while (!done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void awaitPostedUnderLoad(const utl::ParaLooper::Priority priority) {
+    for (std::size_t i = loadedLooper().getAwaitingTasks(); i < BACKGROUND_BACKLOG; ++i) {
+      loadedLooper().post([] {
+        spin(BACKGROUND_TASK);
+      }, utl::ParaLooper::Priority::Background);
+    }
+    awaitPosted(loadedLooper(), priority);
+  }
+
+}
+
+// Post to start of a single task on an idle pool
+UTL_BENCHMARK(paraLooperDispatchLatency) {
+  awaitPosted(looper(), utl::ParaLooper::Priority::Normal);
+}
+
+// 10000 empty tasks posted then waited for
+UTL_BENCHMARK(paraLooperThroughput10k) {
+  for (int i = 0; i < 10000; ++i) {
+    looper().post([] {
+    });
+  }
+  looper().waitTasks();
+}
+
+UTL_BENCHMARK(paraLooperParallelFor1M) {
+  static std::vector<int> values(1 << 20);
+  looper().parallelFor(0, values.size(), [](const std::size_t begin, const std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      values[i] += static_cast<int>(i);
+    }
+  });
+}
+
+// Start latency while the background lane is saturated, the P99 column is the tail
+UTL_BENCHMARK(paraLooperHighUnderLoad) {
+  awaitPostedUnderLoad(utl::ParaLooper::Priority::High);
+}
+
+UTL_BENCHMARK(paraLooperNormalUnderLoad) {
+  awaitPostedUnderLoad(utl::ParaLooper::Priority::Normal);
+}
+
+// Baseline: same lane as the backlog, FIFO behind it as with a single queue
+UTL_BENCHMARK(paraLooperBackgroundUnderLoad) {
+  awaitPostedUnderLoad(utl::ParaLooper::Priority::Background);
+}
@@ -0,0 +1,41 @@
+#include <cstdint>
+
+#include "Bench.hpp"
+#include "RandomNumberGenerator.hpp"
+
+namespace {
+
+  // Numbers drawn per iteration, divide by the average to get numbers per second
+  constexpr int NUMBERS = 100000;
+
+  volatile std::int64_t integerSink;
+  volatile double realSink;
+
+}
+
+UTL_BENCHMARK(rngInteger100k) {
+  static utl::IntegerNumberGenerator<std::int64_t> rng(1);
+  std::int64_t sum = 0;
+  for (int i = 0; i < NUMBERS; ++i) {
+    sum += rng.number();
+  }
+  integerSink = sum;
+}
+
+UTL_BENCHMARK(rngIntegerInterval100k) {
+  static utl::IntegerNumberGenerator<std::int64_t> rng(1);
+  std::int64_t sum = 0;
+  for (int i = 0; i < NUMBERS; ++i) {
+    sum += rng.interval(0, i);
+  }
+  integerSink = sum;
+}
+
+UTL_BENCHMARK(rngReal100k) {
+  static utl::RealNumberGenerator<double> rng(1);
+  double sum = 0.;
+  for (int i = 0; i < NUMBERS; ++i) {
+    sum += rng.number();
+  }
+  realSink = sum;
+}
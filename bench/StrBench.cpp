@@ -0,0 +1,59 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Str.hpp"
+
+namespace {
+
+  // Comma separated fields of 8 characters padded with spaces
+  std::string makeInput(const std::size_t fields) {
+    std::string input = "  \t";
+    for (std::size_t i = 0; i < fields; ++i) {
+      input += (i > 0 ? "," : "") + std::string("field") + std::to_string(i % 1000);
+    }
+    return input + " \n ";
+  }
+
+  const std::string SMALL = makeInput(4);
+  const std::string MEDIUM = makeInput(256);
+  const std::string LARGE = makeInput(16384);
+
+  volatile std::size_t sink;
+
+  void split(const std::string& input) {
+    std::vector<std::string> parts;
+    utl::split(input, ',', parts);
+    sink = parts.size();
+  }
+
+  void trim(const std::string& input) {
+    sink = utl::trim(input).size();
+  }
+
+}
+
+UTL_BENCHMARK(strSplitSmall) {
+  split(SMALL);
+}
+
+UTL_BENCHMARK(strSplitMedium) {
+  split(MEDIUM);
+}
+
+UTL_BENCHMARK(strSplitLarge) {
+  split(LARGE);
+}
+
+UTL_BENCHMARK(strTrimSmall) {
+  trim(SMALL);
+}
+
+UTL_BENCHMARK(strTrimMedium) {
+  trim(MEDIUM);
+}
+
+UTL_BENCHMARK(strTrimLarge) {
+  trim(LARGE);
+}
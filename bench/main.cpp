@@ -0,0 +1,10 @@
+#include "Bench.hpp"
+
+int main() {
+  utl::Bench bench(100);
+  bench.setTimeUnit(utl::Micro);
+  bench.addRegistered();
+  bench.run();
+  bench.save("utl_bench.json", "utl");
+  return 0;
+}
@@ -11,6 +11,37 @@
 #include <string>
 #include <vector>
 
+#include "Clock.hpp"
+#include "Histogram.hpp"
+
+/*
+Self registered benchmark, defined at namespace scope:
+
+UTL_BENCHMARK(vectorPushBack) {
+    std::vector<int> v;
+    for (int i = 0; i < 1000; ++i) v.push_back(i);
+}
+
+Long running benchmark, measured 3 times whatever the bench iterations:
+
+UTL_BENCHMARK_ITERATIONS(sortTenMillion, 3) {
+    ...
+}
+
+utl::Bench bench;
+bench.addRegistered();
+bench.run();
+*/
+
+#define UTL_BENCH_CONCAT_IMPL(a, b) a##b
+#define UTL_BENCH_CONCAT(a, b) UTL_BENCH_CONCAT_IMPL(a, b)
+#define UTL_BENCHMARK_ITERATIONS(name, iterations) \
+  static void UTL_BENCH_CONCAT(utlBenchmark_, name)(); \
+  static const bool UTL_BENCH_CONCAT(utlBenchmarkRegistered_, name) = \
+      utl::Bench::registerFunction(#name, &UTL_BENCH_CONCAT(utlBenchmark_, name), iterations); \
+  static void UTL_BENCH_CONCAT(utlBenchmark_, name)()
+#define UTL_BENCHMARK(name) UTL_BENCHMARK_ITERATIONS(name, 0)
+
 namespace utl {
 
   enum TimeUnit {
@@ -20,6 +51,11 @@ namespace utl {
     Second = 1000000000
   };
 
+  enum ClockSource {
+    Steady,
+    Tsc
+  };
+
   class Bench {
     public:
 
@@ -27,15 +63,39 @@ namespace utl {
         : mIterations(iterations)
         , maxStrLength(0)
         , mTimeUnit(Nano)
+        , mClockSource(Steady)
         , mPrecision(2) {
       }
 
       ~Bench() {
       }
 
-      void add(const std::string& testName, void func(void)) {
+      /**
+       * @param iterations runs of this function, 0 to use the bench iterations
+       */
+      void add(const std::string& testName, void func(void), const std::size_t iterations = 0) {
         maxStrLength = std::max(maxStrLength, testName.length());
-        mFunctions.emplace_back(testName, func);
+        mFunctions.push_back(Function { testName, func, iterations });
+      }
+
+      /**
+       * @brief Register a function for every Bench, used by UTL_BENCHMARK
+       *
+       * @return true, so that it can initialize a static
+       */
+      static bool registerFunction(const std::string& testName, void func(void), const std::size_t iterations = 0) {
+        registry().push_back(Function { testName, func, iterations });
+        return true;
+      }
+
+      /**
+       * @brief Add every function registered with UTL_BENCHMARK
+       *
+       */
+      void addRegistered() {
+        for (auto &f : registry()) {
+          add(f.name, f.func, f.iterations);
+        }
       }
 
       void run(const bool warmUp = true) {
@@ -53,8 +113,8 @@ namespace utl {
         std::cout << "Running on " << getCpu() << std::endl;
         std::cout << "Iterations: " << mIterations << std::endl << std::endl;
         std::cout << std::setw(maxStrLength) << "Benchmark\t" << std::setw(10)
-            << "Min\t" << std::setw(10) << "Max\t" << std::setw(10) << "Avg"
-            << std::setw(0) << std::endl;
+            << "Min\t" << std::setw(10) << "Max\t" << std::setw(10) << "Avg\t"
+            << std::setw(10) << "P99" << std::setw(0) << std::endl;
         for (auto &r : results) {
           std::cout << std::setw(maxStrLength) << std::left << r.name << "\t"
               << std::fixed << std::setw(10) << std::internal
@@ -63,7 +123,9 @@ namespace utl {
               << std::setw(10) << std::setprecision(mPrecision)
               << r.max / static_cast<double>(mTimeUnit) << tuStr << "\t"
               << std::setw(10) << std::setprecision(mPrecision)
-              << r.avg / static_cast<double>(mTimeUnit) << tuStr << std::endl;
+              << r.avg / static_cast<double>(mTimeUnit) << tuStr << "\t"
+              << std::setw(10) << std::setprecision(mPrecision)
+              << r.p99 / static_cast<double>(mTimeUnit) << tuStr << std::endl;
         }
       }
 
@@ -79,7 +141,9 @@ namespace utl {
         for (auto &r : results) {
           file << "{\"name\":\"" << r.name << "\", " << "\"result\":"
               << std::fixed << std::setprecision(mPrecision)
-              << r.avg / static_cast<double>(mTimeUnit) << "}";
+              << r.avg / static_cast<double>(mTimeUnit) << ", \"p50\":"
+              << r.p50 / static_cast<double>(mTimeUnit) << ", \"p99\":"
+              << r.p99 / static_cast<double>(mTimeUnit) << "}";
 
           if (idx < results.size() - 1) {
             file << ",";
@@ -126,45 +190,78 @@ namespace utl {
         mTimeUnit = timeUnit;
       }
 
+      ClockSource getClockSource() const {
+        return mClockSource;
+      }
+
+      void setClockSource(const ClockSource clockSource) {
+        mClockSource = clockSource;
+        if (clockSource == Tsc) {
+          TscClock::calibrate();
+        }
+      }
+
     private:
       struct Result {
           std::string name;
           double min;
           double max;
           double avg;
-          Result(const std::string& name, const double min, const double max, const double avg)
-              : name(name), min(min), max(max), avg(avg) {
+          double p50;
+          double p99;
+          Result(const std::string& name, const Histogram& histogram)
+              : name(name)
+              , min(histogram.getMin())
+              , max(histogram.getMax())
+              , avg(histogram.getMean())
+              , p50(histogram.percentile(50.))
+              , p99(histogram.percentile(99.)) {
           }
 
           bool operator<(const Result& r) {
             return avg < r.avg;
           }
       };
+      struct Function {
+          std::string name;
+          void (*func)();
+          std::size_t iterations;
+      };
       std::size_t mIterations;
-      std::vector<std::pair<std::string, void (*)()>> mFunctions;
+      std::vector<Function> mFunctions;
       std::vector<Result> results;
       std::size_t maxStrLength;
       TimeUnit mTimeUnit;
+      ClockSource mClockSource;
       std::size_t mPrecision;
+      Histogram mHistogram;
+
+      static std::vector<Function>& registry() {
+        static std::vector<Function> functions;
+        return functions;
+      }
+
+      void exec(const bool log) {
+        if (mClockSource == Tsc) {
+          exec<TscClock>(log);
+        } else {
+          exec<SteadyClock>(log);
+        }
+      }
 
+      template<typename Clock>
       void exec(const bool log) {
         for (auto &f : mFunctions) {
-          double time = 0;
-          double min = 1000000.;
-          double max = 0;
-          for (std::size_t i = 0; i < mIterations; ++i) {
-            auto start = std::chrono::steady_clock::now();
-            f.second();
-            double res = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::steady_clock::now() - start).count();
-            time += res;
-            min = std::min(min, res);
-            max = std::max(max, res);
+          mHistogram.reset();
+          const std::size_t iterations = f.iterations > 0 ? f.iterations : mIterations;
+          for (std::size_t i = 0; i < iterations; ++i) {
+            const std::uint64_t start = Clock::begin();
+            f.func();
+            const std::uint64_t end = Clock::end();
+            mHistogram.record(static_cast<std::uint64_t>(Clock::toNanoSeconds(end - start)));
           }
           if (log) {
-            results.emplace_back(
-                Result(f.first, min, max,
-                       time / static_cast<double>(mIterations)));
+            results.emplace_back(f.name, mHistogram);
           }
         }
       }
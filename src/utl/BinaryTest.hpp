@@ -1,12 +1,23 @@
 #ifndef BINARYTEST_HPP
 #define BINARYTEST_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "ParaLooper.hpp"
+#include "RandomNumberGenerator.hpp"
+
 /*
 test.add("test", true, std::function<bool()>(
     []() {
@@ -15,8 +26,52 @@ test.add("test", true, std::function<bool()>(
         return a - b == 0.f;
     })
 );
+
+test.addProperty("trim is idempotent",
+    [](utl::BinaryTest::Generators& g) {
+        std::string s(g.integer.interval(0, 32), ' ');
+        for (auto &c : s) c = static_cast<char>(g.integer.interval(9, 126));
+        return s;
+    },
+    [](const std::string& s) {
+        return utl::trim(utl::trim(s)) == utl::trim(s);
+    }, 10000
+);
+
+Self registered test, defined at namespace scope:
+
+UTL_TEST(floatSubtraction, true) {
+    float a = 1.f;
+    return a - a == 0.f;
+}
+
+Self registered property, generator and predicate being named functions
+or lambdas without top level commas:
+
+static std::string trimInput(utl::BinaryTest::Generators& g) {
+    return std::string(g.integer.interval(0, 32), ' ') + "a";
+}
+
+static bool trimIsIdempotent(const std::string& s) {
+    return utl::trim(utl::trim(s)) == utl::trim(s);
+}
+
+UTL_PROPERTY(trimIsIdempotent, trimInput, trimIsIdempotent, 10000);
+
+test.addRegistered();
 */
 
+#define UTL_TEST_CONCAT_IMPL(a, b) a##b
+#define UTL_TEST_CONCAT(a, b) UTL_TEST_CONCAT_IMPL(a, b)
+#define UTL_TEST(name, expected) \
+  static bool UTL_TEST_CONCAT(utlTest_, name)(); \
+  static const bool UTL_TEST_CONCAT(utlTestRegistered_, name) = \
+      utl::BinaryTest::registerTest(#name, expected, &UTL_TEST_CONCAT(utlTest_, name)); \
+  static bool UTL_TEST_CONCAT(utlTest_, name)()
+#define UTL_PROPERTY(name, generator, predicate, iterations) \
+  static const bool UTL_TEST_CONCAT(utlPropertyRegistered_, name) = \
+      utl::BinaryTest::registerProperty(#name, generator, predicate, iterations)
+
 namespace utl {
 
   class BinaryTest {
@@ -24,10 +79,32 @@ namespace utl {
 
       enum class ShowTest { ALL, ERRORS };
 
+      /**
+       * @brief Random sources handed to property generators, reseeded
+       * for every iteration so that any input can be replayed from the seed
+       */
+      struct Generators {
+          RealNumberGenerator<double> real;
+          IntegerNumberGenerator<std::int64_t> integer;
+
+          Generators()
+            : real(0)
+            , integer(0) {
+          }
+
+          void seed(const std::uint32_t value) {
+            real.seed(value);
+            integer.seed(value ^ 0x9e3779b9u);
+          }
+      };
+
+      static constexpr std::uint32_t DEFAULT_SEED = 0x5eed1234u;
+
       BinaryTest(const std::string& title = "Test", const bool enhancedDisplay = false)
         : maxSize(0)
         , mTitle(title)
-        , mEnhancedDisplay(enhancedDisplay) {
+        , mEnhancedDisplay(enhancedDisplay)
+        , mSeed(DEFAULT_SEED) {
       }
 
       ~BinaryTest() {
@@ -35,14 +112,86 @@ namespace utl {
 
       void add(const std::string& name, const bool expected, std::function<bool()> func) {
         maxSize = std::max(name.size(), maxSize);
-        tests.emplace_back(name, expected, func);
+        tests.emplace_back(name, expected, false, [func](ParaLooper*, std::string&) {
+          return func();
+        });
+      }
+
+      /**
+       * @brief Register a test for every BinaryTest, used by UTL_TEST
+       *
+       * @return true, so that it can initialize a static
+       */
+      static bool registerTest(const std::string& name, const bool expected, bool func(void)) {
+        registry().push_back([name, expected, func](BinaryTest& test) {
+          test.add(name, expected, func);
+        });
+        return true;
+      }
+
+      /**
+       * @brief Register a property for every BinaryTest, used by UTL_PROPERTY
+       *
+       * @return true, so that it can initialize a static
+       */
+      template<typename G, typename P>
+        static bool registerProperty(const std::string& name, G generator, P predicate, const std::size_t iterations = 100) {
+          registry().push_back([name, generator, predicate, iterations](BinaryTest& test) {
+            test.addProperty(name, generator, predicate, iterations);
+          });
+          return true;
+        }
+
+      /**
+       * @brief Add every test registered with UTL_TEST or UTL_PROPERTY
+       *
+       */
+      void addRegistered() {
+        for (auto &registration : registry()) {
+          registration(*this);
+        }
+      }
+
+      /**
+       * @brief Add a property checked against randomly generated inputs
+       *
+       * Iterations run in parallel, iteration i drawing its input from
+       * Generators seeded with (seed, i). The first failing input is
+       * shrunk toward a minimal counterexample and reported with the seed.
+       *
+       * @param name test name
+       * @param generator callable T(Generators&) producing an input
+       * @param predicate callable bool(const T&) which must hold for every input
+       * @param iterations number of inputs to check
+       */
+      template<typename G, typename P>
+        void addProperty(const std::string& name, G generator, P predicate, const std::size_t iterations = 100) {
+          using T = std::decay_t<std::invoke_result_t<G&, Generators&>>;
+          const std::uint32_t seed = mSeed;
+          maxSize = std::max(name.size(), maxSize);
+          tests.emplace_back(name, true, true, [generator, predicate, iterations, seed](ParaLooper* looper, std::string& details) {
+            return checkProperty<T>(*looper, generator, predicate, iterations, seed, details);
+          });
+        }
+
+      void setSeed(const std::uint32_t seed) {
+        mSeed = seed;
+      }
+
+      std::uint32_t getSeed() const {
+        return mSeed;
       }
 
       void setTitle(const std::string& title) {
         mTitle = title;
       }
 
-      void run(const ShowTest& show) {
+      /**
+       * @brief Run every test and print the summary
+       *
+       * @return true when every test passed
+       */
+      bool run(const ShowTest& show) {
         std::size_t passed = 0;
         std::size_t failed = 0;
         const std::string_view ok = mEnhancedDisplay ? "\x1b[1;32m\u2713" : "";
@@ -52,9 +201,16 @@ namespace utl {
 
         std::cout << mTitle << std::endl << std::endl;
 
+        // One pool shared by every property of this run
+        std::unique_ptr<ParaLooper> looper;
+        if (std::any_of(tests.begin(), tests.end(), [](const Test& t) { return t.property; })) {
+          looper = std::make_unique<ParaLooper>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+
         for (auto &t : tests) {
 
-          const bool b = t.expectedResult == t.func();
+          std::string details;
+          const bool b = t.expectedResult == t.func(looper.get(), details);
           b ? passed++ : failed++;
           if(show == ShowTest::ALL || (show == ShowTest::ERRORS && !b)) {
             std::cout << (b ? ok : ko)
@@ -66,6 +222,9 @@ namespace utl {
                 << std::setw(6)
                 << std::right
                 << (b ? passedStr : failedStr);
+            if (!b && !details.empty()) {
+              std::cout << "     " << details << std::endl;
+            }
           }
         }
 
@@ -89,6 +248,7 @@ namespace utl {
         if (mEnhancedDisplay) {
           std::cout << "\x1b[0m" << std::endl;
         }
+        return failed == 0;
       }
 
       void clear() {
@@ -100,19 +260,192 @@ namespace utl {
       struct Test {
           std::string name;
           bool expectedResult;
-          std::function<bool()> func;
+          bool property;
+          std::function<bool(ParaLooper*, std::string&)> func;
 
-          Test(const std::string& name, bool expectedResult, std::function<bool()> func)
+          Test(const std::string& name, bool expectedResult, bool property, std::function<bool(ParaLooper*, std::string&)> func)
             : name(name)
             , expectedResult(expectedResult)
+            , property(property)
             , func(func) {
           }
       };
 
+      static constexpr std::size_t MAX_SHRINK_STEPS = 10000;
+
       std::vector<Test> tests;
       std::size_t maxSize;
       std::string mTitle;
       bool mEnhancedDisplay;
+      std::uint32_t mSeed;
+
+      static std::vector<std::function<void(BinaryTest&)>>& registry() {
+        static std::vector<std::function<void(BinaryTest&)>> registered;
+        return registered;
+      }
+
+      static std::uint32_t iterationSeed(const std::uint32_t seed, const std::size_t iteration) {
+        std::uint64_t x = (static_cast<std::uint64_t>(seed) << 32) ^ iteration;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<std::uint32_t>(x ^ (x >> 31));
+      }
+
+      template<typename T, typename G, typename P>
+        static bool checkProperty(ParaLooper& looper, G generator, P predicate, const std::size_t iterations,
+                                  const std::uint32_t seed, std::string& details) {
+          // Lowest failing iteration, so the reported case doesn't depend on scheduling
+          std::atomic<std::size_t> firstFailure(iterations);
+          looper.execute([&](const std::size_t id, const std::size_t jobs) {
+            Generators generators;
+            G gen(generator);
+            for (std::size_t i = id; i < firstFailure.load(std::memory_order_relaxed); i += jobs) {
+              generators.seed(iterationSeed(seed, i));
+              if (!predicate(static_cast<const T&>(gen(generators)))) {
+                std::size_t current = firstFailure.load();
+                while (i < current && !firstFailure.compare_exchange_weak(current, i)) {
+                }
+                return;
+              }
+            }
+          });
+
+          const std::size_t failure = firstFailure.load();
+          if (failure == iterations) {
+            return true;
+          }
+
+          Generators generators;
+          generators.seed(iterationSeed(seed, failure));
+          T value = generator(generators);
+          std::size_t steps = 0;
+          bool shrunk = true;
+          while (shrunk && steps < MAX_SHRINK_STEPS) {
+            shrunk = false;
+            for (auto &candidate : shrinkCandidates(value)) {
+              if (!predicate(static_cast<const T&>(candidate))) {
+                value = std::move(candidate);
+                shrunk = true;
+                ++steps;
+                break;
+              }
+            }
+          }
+
+          std::ostringstream oss;
+          oss << "seed " << seed << ", iteration " << failure << ", " << steps << " shrinks, counterexample: ";
+          print(oss, value);
+          details = oss.str();
+          return false;
+        }
+
+      template<typename T>
+        static constexpr auto isPrintable(int) -> decltype(std::declval<std::ostream&>() << std::declval<const T&>(), bool()) {
+          return true;
+        }
+
+      template<typename T>
+        static constexpr bool isPrintable(...) {
+          return false;
+        }
+
+      template<typename T>
+        static void print(std::ostream& os, const T& value) {
+          if constexpr (std::is_same_v<T, std::string>) {
+            os << "\"" << value << "\"";
+          } else if constexpr (isPrintable<T>(0)) {
+            os << value;
+          } else if constexpr (isSequence<T>(0)) {
+            os << "[";
+            for (std::size_t i = 0; i < value.size(); ++i) {
+              if (i > 0) {
+                os << ", ";
+              }
+              print(os, value[i]);
+            }
+            os << "]";
+          } else {
+            os << "<not printable>";
+          }
+        }
+
+      template<typename T>
+        static std::vector<T> shrinkCandidates(const T& value) {
+          std::vector<T> candidates;
+          if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+            if (value != 0) {
+              candidates.push_back(0);
+              if constexpr (std::is_signed_v<T>) {
+                if (value < 0 && value != std::numeric_limits<T>::min()) {
+                  candidates.push_back(-value);
+                }
+              }
+              // Halve the distance to zero, biggest jumps first, so that repeated
+              // shrinks binary search down to the passing boundary
+              for (T distance = value / 2; distance != 0; distance /= 2) {
+                candidates.push_back(value - distance);
+              }
+              candidates.push_back(value > 0 ? value - 1 : value + 1);
+            }
+          } else if constexpr (std::is_floating_point_v<T>) {
+            if (value != 0 && value == value) {
+              candidates.push_back(0);
+              if (value < 0) {
+                candidates.push_back(-value);
+              }
+              if (std::trunc(value) != value) {
+                candidates.push_back(std::trunc(value));
+              }
+              if (value / 2 != 0) {
+                candidates.push_back(value / 2);
+              }
+            }
+          } else if constexpr (isSequence<T>(0)) {
+            // Remove halves, then single elements, then shrink single elements
+            const std::size_t size = value.size();
+            for (std::size_t chunk = size / 2; chunk > 0; chunk /= 2) {
+              for (std::size_t start = 0; start + chunk <= size; start += chunk) {
+                T candidate(value);
+                candidate.erase(candidate.begin() + start, candidate.begin() + start + chunk);
+                candidates.push_back(std::move(candidate));
+              }
+              if (chunk == 1) {
+                break;
+              }
+            }
+            if (size == 1) {
+              candidates.emplace_back();
+            }
+            for (std::size_t i = 0; i < size; ++i) {
+              for (auto &element : shrinkCandidates(value[i])) {
+                T candidate(value);
+                candidate[i] = element;
+                candidates.push_back(std::move(candidate));
+              }
+            }
+          }
+          return candidates;
+        }
+
+      static std::vector<char> shrinkCandidates(const char& value) {
+        // Shrink characters toward 'a' rather than toward '\0'
+        std::vector<char> candidates;
+        if (value != 'a') {
+          candidates.push_back('a');
+        }
+        return candidates;
+      }
+
+      template<typename T>
+        static constexpr auto isSequence(int) -> decltype(std::declval<T&>().erase(std::declval<T&>().begin()),
+                                                          std::declval<T&>()[0], bool()) {
+          return true;
+        }
+
+      template<typename T>
+        static constexpr bool isSequence(...) {
+          return false;
+        }
   };
 
 }
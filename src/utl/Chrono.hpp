@@ -1,16 +1,20 @@
 #ifndef UTLCHRONO_HPP
 #define UTLCHRONO_HPP
 
-#include <chrono>
+#include <cstdint>
+
+#include "Clock.hpp"
+#include "Histogram.hpp"
 
 namespace utl {
 
-  class Chrono {
+  template<typename Clock>
+  class BasicChrono {
 
     public:
 
-      Chrono(const bool autoStart = false)
-        : mStart{}
+      BasicChrono(const bool autoStart = false)
+        : mStart(0)
         , mDuration(0)
         , mRunning(false) {
         if (autoStart) {
@@ -18,7 +22,7 @@ namespace utl {
         }
       }
 
-      ~Chrono() {
+      ~BasicChrono() {
       }
 
       /**
@@ -26,9 +30,9 @@ namespace utl {
        *
        */
       void start() {
-        mDuration = 0.;
-        mStart = std::chrono::steady_clock::now();
+        mDuration = 0;
         mRunning = true;
+        mStart = Clock::begin();
       }
 
       /**
@@ -36,8 +40,20 @@ namespace utl {
        *
        */
       void stop() {
-        mDuration += getDuration();
-        mRunning = false;
+        if (mRunning) {
+          mDuration += Clock::end() - mStart;
+          mRunning = false;
+        }
+      }
+
+      /**
+       * @brief Stop the timer and record the elapsed time as nano seconds
+       *
+       * @param histogram histogram receiving the elapsed time
+       */
+      void stop(Histogram& histogram) {
+        stop();
+        histogram.record(static_cast<std::uint64_t>(asNanoSeconds()));
       }
 
       /**
@@ -45,32 +61,38 @@ namespace utl {
        *
        */
       void resume() {
-        mStart = std::chrono::steady_clock::now();
         mRunning = true;
+        mStart = Clock::begin();
       }
 
       /**
-       * @brief Elapsed time as nano seconds
+       * @brief Elapsed time as raw clock ticks
        *
-       * @return elapsed time as nano seconds
+       * @return elapsed ticks
        */
-      const double asNanoSeconds() {
+      std::uint64_t asTicks() const {
         if (mRunning) {
-          return mDuration + getDuration();
+          return mDuration + Clock::end() - mStart;
         }
         return mDuration;
       }
 
+      /**
+       * @brief Elapsed time as nano seconds
+       *
+       * @return elapsed time as nano seconds
+       */
+      const double asNanoSeconds() const {
+        return Clock::toNanoSeconds(asTicks());
+      }
+
       /**
        * @brief Elapsed time as micro seconds
        *
        * @return elapsed time as micro seconds
        */
-      const double asMicroSeconds() {
-        if (mRunning) {
-          return (mDuration + getDuration()) / TO_MICRO;
-        }
-        return mDuration > 0. ? mDuration / TO_MICRO : 0.;
+      const double asMicroSeconds() const {
+        return asNanoSeconds() / TO_MICRO;
       }
 
       /**
@@ -78,11 +100,8 @@ namespace utl {
        *
        * @return elapsed time as milli seconds
        */
-      const double asMilliSeconds() {
-        if (mRunning) {
-          return (mDuration + getDuration()) / TO_MILLI;
-        }
-        return mDuration > 0. ? mDuration / TO_MILLI : 0.;
+      const double asMilliSeconds() const {
+        return asNanoSeconds() / TO_MILLI;
       }
 
       /**
@@ -90,33 +109,22 @@ namespace utl {
        *
        * @return elapsed time as seconds
        */
-      const double asSeconds() {
-        if (mRunning) {
-          return (mDuration + getDuration()) / TO_SEC;
-        }
-        return mDuration > 0. ? mDuration / TO_SEC : 0.;
+      const double asSeconds() const {
+        return asNanoSeconds() / TO_SEC;
       }
 
     private:
       static constexpr double TO_MICRO = 1000.0;
       static constexpr double TO_MILLI = TO_MICRO * 1000.0;
       static constexpr double TO_SEC = TO_MILLI * 1000.0;
-      std::chrono::time_point<std::chrono::steady_clock> mStart;
-      double mDuration;
+      std::uint64_t mStart;
+      std::uint64_t mDuration;
       bool mRunning;
 
-      double getDuration() {
-        const std::chrono::duration<double, std::nano> isZero = mStart
-            - std::chrono::time_point<std::chrono::steady_clock> {};
-
-        if (isZero.count() > 0) {
-          return (std::chrono::steady_clock::now() - mStart).count();
-        }
-
-        return 0;
-      }
-
   };
 
+  using Chrono = BasicChrono<SteadyClock>;
+  using TscChrono = BasicChrono<TscClock>;
+
 }
 #endif // UTLCHRONO_HPP
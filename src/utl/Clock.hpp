@@ -0,0 +1,173 @@
+#ifndef UTLCLOCK_HPP
+#define UTLCLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UTL_HAS_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace utl {
+
+  /**
+   * @brief Tick source backed by std::chrono::steady_clock
+   *
+   */
+  struct SteadyClock {
+
+      /**
+       * @brief Read the clock at the beginning of a timed section
+       *
+       * @return current ticks
+       */
+      static std::uint64_t begin() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+      }
+
+      /**
+       * @brief Read the clock at the end of a timed section
+       *
+       * @return current ticks
+       */
+      static std::uint64_t end() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+      }
+
+      /**
+       * @brief Convert ticks to nano seconds
+       *
+       * @return ticks as nano seconds
+       */
+      static double toNanoSeconds(const std::uint64_t ticks) {
+        using Period = std::ratio_divide<std::chrono::steady_clock::period, std::nano>;
+        return static_cast<double>(ticks) * Period::num / Period::den;
+      }
+  };
+
+  /**
+   * @brief Tick source reading the time stamp counter
+   *
+   * Reads are fenced so that the timed section cannot be reordered around
+   * them. Ticks are converted with a ratio calibrated once against
+   * steady_clock. Without an invariant TSC, or off x86, it falls back to
+   * steady_clock.
+   */
+  class TscClock {
+
+    public:
+
+      /**
+       * @brief Read the counter at the beginning of a timed section
+       *
+       * @return current ticks
+       */
+      static std::uint64_t begin() {
+#ifdef UTL_HAS_TSC
+        if (isInvariant()) {
+          _mm_lfence();
+          const std::uint64_t ticks = __rdtsc();
+          _mm_lfence();
+          return ticks;
+        }
+#endif
+        return SteadyClock::begin();
+      }
+
+      /**
+       * @brief Read the counter at the end of a timed section
+       *
+       * @return current ticks
+       */
+      static std::uint64_t end() {
+#ifdef UTL_HAS_TSC
+        if (isInvariant()) {
+          unsigned int aux;
+          const std::uint64_t ticks = __rdtscp(&aux);
+          _mm_lfence();
+          return ticks;
+        }
+#endif
+        return SteadyClock::end();
+      }
+
+      /**
+       * @brief Convert ticks to nano seconds
+       *
+       * @return ticks as nano seconds
+       */
+      static double toNanoSeconds(const std::uint64_t ticks) {
+        return static_cast<double>(ticks) * calibrate();
+      }
+
+      /**
+       * @brief Calibrate the counter against steady_clock, only the first
+       * call measures. Call it at startup to keep it out of timed code.
+       *
+       * @return nano seconds per tick
+       */
+      static double calibrate() {
+        static const double nsPerTick = measureNsPerTick();
+        return nsPerTick;
+      }
+
+      /**
+       * @brief Counter frequency
+       *
+       * @return ticks per second
+       */
+      static double getFrequency() {
+        return 1e9 / calibrate();
+      }
+
+      /**
+       * @brief Whether ticks come from an invariant TSC
+       *
+       * @return true if the TSC is used
+       */
+      static bool isInvariant() {
+        static const bool invariant = detectInvariant();
+        return invariant;
+      }
+
+    private:
+      static constexpr std::chrono::milliseconds CALIBRATION_TIME { 20 };
+
+      static bool detectInvariant() {
+#ifdef UTL_HAS_TSC
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+          return false;
+        }
+        __cpuid(0x80000007, eax, ebx, ecx, edx);
+        if (!(edx & (1u << 8))) {
+          return false;
+        }
+        // rdtscp availability
+        __cpuid(0x80000001, eax, ebx, ecx, edx);
+        return edx & (1u << 27);
+#else
+        return false;
+#endif
+      }
+
+      static double measureNsPerTick() {
+        if (!isInvariant()) {
+          return SteadyClock::toNanoSeconds(1);
+        }
+        const auto startTime = std::chrono::steady_clock::now();
+        const std::uint64_t startTicks = begin();
+        auto endTime = startTime;
+        while (endTime - startTime < CALIBRATION_TIME) {
+          endTime = std::chrono::steady_clock::now();
+        }
+        const std::uint64_t endTicks = end();
+        const double ns = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+        return ns / static_cast<double>(endTicks - startTicks);
+      }
+  };
+
+}
+#endif // UTLCLOCK_HPP
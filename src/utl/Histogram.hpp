@@ -0,0 +1,262 @@
+#ifndef UTLHISTOGRAM_HPP
+#define UTLHISTOGRAM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace utl {
+
+  /**
+   * @brief Log-linear histogram of non negative integer values (HdrHistogram
+   * layout). Values up to the highest trackable value are recorded in O(1)
+   * with a relative error bounded by the number of significant digits.
+   * Memory is allocated once at construction.
+   */
+  class Histogram {
+    public:
+
+      /**
+       * @param highestTrackableValue values above are clamped, default one hour in nano seconds
+       * @param significantDigits precision kept for every value, between 1 and 5
+       */
+      Histogram(const std::uint64_t highestTrackableValue = 3600000000000ull, const int significantDigits = 3)
+        : mHighestTrackableValue(std::max<std::uint64_t>(highestTrackableValue, 2))
+        , mSignificantDigits(std::clamp(significantDigits, 1, 5))
+        , mTotalCount(0)
+        , mSum(0)
+        , mMin(UINT64_MAX)
+        , mMax(0) {
+        const std::uint64_t largestSingleUnitValue = 2 * static_cast<std::uint64_t>(std::pow(10, mSignificantDigits));
+        const int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largestSingleUnitValue))));
+        mSubBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+        mSubBucketCount = std::uint64_t(1) << subBucketCountMagnitude;
+        mSubBucketHalfCount = mSubBucketCount / 2;
+        mSubBucketMask = mSubBucketCount - 1;
+
+        int bucketCount = 1;
+        std::uint64_t smallestUntrackableValue = mSubBucketCount;
+        while (smallestUntrackableValue <= mHighestTrackableValue) {
+          if (smallestUntrackableValue > (UINT64_MAX >> 1)) {
+            ++bucketCount;
+            break;
+          }
+          smallestUntrackableValue <<= 1;
+          ++bucketCount;
+        }
+        mCounts.assign(static_cast<std::size_t>(bucketCount + 1) * mSubBucketHalfCount, 0);
+      }
+
+      ~Histogram() {
+      }
+
+      /**
+       * @brief Record a value, clamped to the highest trackable value
+       *
+       */
+      void record(const std::uint64_t value) {
+        record(value, 1);
+      }
+
+      /**
+       * @brief Record a value count times
+       *
+       */
+      void record(std::uint64_t value, const std::uint64_t count) {
+        value = std::min(value, mHighestTrackableValue);
+        mCounts[countsIndex(value)] += count;
+        mTotalCount += count;
+        mSum += value * count;
+        mMin = std::min(mMin, value);
+        mMax = std::max(mMax, value);
+      }
+
+      /**
+       * @brief Add the counts of another histogram, typically a per thread
+       * instance, both must share the same configuration
+       *
+       */
+      void merge(const Histogram& other) {
+        if (other.mCounts.size() != mCounts.size() || other.mSubBucketCount != mSubBucketCount) {
+          throw std::invalid_argument("Histogram::merge: incompatible histograms");
+        }
+        for (std::size_t i = 0; i < mCounts.size(); ++i) {
+          mCounts[i] += other.mCounts[i];
+        }
+        mTotalCount += other.mTotalCount;
+        mSum += other.mSum;
+        mMin = std::min(mMin, other.mMin);
+        mMax = std::max(mMax, other.mMax);
+      }
+
+      void reset() {
+        std::fill(mCounts.begin(), mCounts.end(), 0);
+        mTotalCount = 0;
+        mSum = 0;
+        mMin = UINT64_MAX;
+        mMax = 0;
+      }
+
+      /**
+       * @brief Value at a given percentile
+       *
+       * @param percentile between 0 and 100
+       * @return highest value equivalent to the recorded one at that percentile
+       */
+      std::uint64_t percentile(const double percentile) const {
+        if (mTotalCount == 0) {
+          return 0;
+        }
+        const double p = std::clamp(percentile, 0., 100.);
+        const std::uint64_t target = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(p / 100. * static_cast<double>(mTotalCount))));
+        std::uint64_t cumulated = 0;
+        for (std::size_t i = 0; i < mCounts.size(); ++i) {
+          cumulated += mCounts[i];
+          if (cumulated >= target) {
+            return std::min(highestEquivalentValue(valueFromIndex(i)), mMax);
+          }
+        }
+        return mMax;
+      }
+
+      std::uint64_t getTotalCount() const {
+        return mTotalCount;
+      }
+
+      std::uint64_t getMin() const {
+        return mTotalCount > 0 ? mMin : 0;
+      }
+
+      std::uint64_t getMax() const {
+        return mMax;
+      }
+
+      double getMean() const {
+        return mTotalCount > 0 ? static_cast<double>(mSum) / static_cast<double>(mTotalCount) : 0.;
+      }
+
+      std::uint64_t getHighestTrackableValue() const {
+        return mHighestTrackableValue;
+      }
+
+      int getSignificantDigits() const {
+        return mSignificantDigits;
+      }
+
+      /**
+       * @brief Compact binary form: configuration, summary then (index delta, count)
+       * pairs for non empty buckets, every integer LEB128 encoded
+       *
+       * @return serialized histogram
+       */
+      std::string serialize() const {
+        std::string out;
+        writeVarint(out, mHighestTrackableValue);
+        writeVarint(out, static_cast<std::uint64_t>(mSignificantDigits));
+        writeVarint(out, mTotalCount);
+        writeVarint(out, mSum);
+        writeVarint(out, getMin());
+        writeVarint(out, mMax);
+        std::size_t previous = 0;
+        for (std::size_t i = 0; i < mCounts.size(); ++i) {
+          if (mCounts[i] > 0) {
+            writeVarint(out, i - previous);
+            writeVarint(out, mCounts[i]);
+            previous = i;
+          }
+        }
+        return out;
+      }
+
+      static Histogram deserialize(const std::string& data) {
+        std::size_t pos = 0;
+        const std::uint64_t highestTrackableValue = readVarint(data, pos);
+        const std::uint64_t significantDigits = readVarint(data, pos);
+        Histogram histogram(highestTrackableValue, static_cast<int>(significantDigits));
+        histogram.mTotalCount = readVarint(data, pos);
+        histogram.mSum = readVarint(data, pos);
+        histogram.mMin = readVarint(data, pos);
+        histogram.mMax = readVarint(data, pos);
+        if (histogram.mTotalCount == 0) {
+          histogram.mMin = UINT64_MAX;
+        }
+        std::size_t index = 0;
+        while (pos < data.size()) {
+          index += readVarint(data, pos);
+          if (index >= histogram.mCounts.size()) {
+            throw std::invalid_argument("Histogram::deserialize: bucket out of range");
+          }
+          histogram.mCounts[index] = readVarint(data, pos);
+        }
+        return histogram;
+      }
+
+    private:
+      std::uint64_t mHighestTrackableValue;
+      int mSignificantDigits;
+      int mSubBucketHalfCountMagnitude;
+      std::uint64_t mSubBucketCount;
+      std::uint64_t mSubBucketHalfCount;
+      std::uint64_t mSubBucketMask;
+      std::vector<std::uint64_t> mCounts;
+      std::uint64_t mTotalCount;
+      std::uint64_t mSum;
+      std::uint64_t mMin;
+      std::uint64_t mMax;
+
+      int bucketIndex(const std::uint64_t value) const {
+        // Highest set bit above the sub bucket range gives the bucket
+        return (63 - mSubBucketHalfCountMagnitude) - __builtin_clzll(value | mSubBucketMask);
+      }
+
+      std::size_t countsIndex(const std::uint64_t value) const {
+        const int bucket = bucketIndex(value);
+        const std::uint64_t subBucket = value >> bucket;
+        return (static_cast<std::size_t>(bucket + 1) << mSubBucketHalfCountMagnitude)
+            + static_cast<std::size_t>(subBucket - mSubBucketHalfCount);
+      }
+
+      std::uint64_t valueFromIndex(const std::size_t index) const {
+        int bucket = static_cast<int>(index >> mSubBucketHalfCountMagnitude) - 1;
+        std::uint64_t subBucket = (index & (mSubBucketHalfCount - 1)) + mSubBucketHalfCount;
+        if (bucket < 0) {
+          subBucket -= mSubBucketHalfCount;
+          bucket = 0;
+        }
+        return subBucket << bucket;
+      }
+
+      std::uint64_t highestEquivalentValue(const std::uint64_t value) const {
+        return value + (std::uint64_t(1) << bucketIndex(value)) - 1;
+      }
+
+      static void writeVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+          out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+          value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+      }
+
+      static std::uint64_t readVarint(const std::string& data, std::size_t& pos) {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+          if (pos >= data.size()) {
+            throw std::invalid_argument("Histogram::deserialize: truncated data");
+          }
+          const std::uint8_t byte = static_cast<std::uint8_t>(data[pos++]);
+          value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+          if (!(byte & 0x80)) {
+            return value;
+          }
+        }
+        throw std::invalid_argument("Histogram::deserialize: malformed varint");
+      }
+  };
+
+}
+#endif // UTLHISTOGRAM_HPP
@@ -0,0 +1,385 @@
+#ifndef PARAALGORITHMS_HPP_
+#define PARAALGORITHMS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ParaLooper.hpp"
+
+/*
+utl::ParaLooper looper;
+std::vector<float> values = ...;
+std::vector<float> scratch;
+
+utl::parallelRadixSort(looper, values.begin(), values.end(), scratch);
+utl::parallelSort(looper, names.begin(), names.end(), nameScratch, std::greater<>());
+*/
+
+namespace utl {
+
+  namespace detail {
+
+    // Below this size the parallel versions only add overhead
+    static constexpr std::size_t PARALLEL_THRESHOLD = 1 << 15;
+
+    static inline std::size_t chunkBegin(const std::size_t size, const std::size_t id, const std::size_t jobs) {
+      return size * id / jobs;
+    }
+
+    /**
+     * @brief Co-rank of k in the merge of a[0, m) and b[0, n): the number of
+     * elements of a among the first k merged ones, a winning ties
+     */
+    template<typename ItA, typename ItB, typename Compare>
+      std::size_t coRank(const std::size_t k, ItA a, const std::size_t m, ItB b, const std::size_t n, Compare& comp) {
+        std::size_t lo = k > n ? k - n : 0;
+        std::size_t hi = std::min(k, m);
+        while (lo < hi) {
+          const std::size_t i = lo + (hi - lo) / 2;
+          if (comp(b[k - i - 1], a[i])) {
+            hi = i;
+          } else {
+            lo = i + 1;
+          }
+        }
+        return lo;
+      }
+
+    /**
+     * @brief Stable merge moving elements, comp only sees lvalues
+     */
+    template<typename InIt, typename OutIt, typename Compare>
+      void moveMerge(InIt a, const InIt aEnd, InIt b, const InIt bEnd, OutIt out, Compare& comp) {
+        while (a != aEnd && b != bEnd) {
+          if (comp(*b, *a)) {
+            *out++ = std::move(*b++);
+          } else {
+            *out++ = std::move(*a++);
+          }
+        }
+        out = std::move(a, aEnd, out);
+        std::move(b, bEnd, out);
+      }
+
+    /**
+     * @brief Keys are at most 64 bits wide, which rules out extended
+     * long double and 128 bit integers
+     */
+    template<typename T>
+      constexpr bool IS_RADIX_SORTABLE = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8;
+
+    template<typename T>
+      using RadixKey = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+                       std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                       std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+    /**
+     * @brief Map a value to an unsigned key with the same ordering
+     */
+    template<typename T>
+      RadixKey<T> radixKey(const T value) {
+        using K = RadixKey<T>;
+        constexpr K signBit = K(1) << (sizeof(T) * 8 - 1);
+        if constexpr (std::is_floating_point_v<T>) {
+          K bits;
+          std::memcpy(&bits, &value, sizeof(T));
+          return (bits & signBit) ? K(~bits) : K(bits | signBit);
+        } else if constexpr (std::is_signed_v<T>) {
+          return K(static_cast<K>(value) ^ signBit);
+        } else {
+          return static_cast<K>(value);
+        }
+      }
+
+  }
+
+  /**
+   * @brief Stable parallel merge sort: chunks are sorted concurrently then
+   * merged pairwise, every merge being split across workers
+   *
+   * @param scratch temporary storage, resized to the range size and reusable
+   */
+  template<typename RandomIt, typename Compare = std::less<>>
+    void parallelSort(ParaLooper& looper, RandomIt first, RandomIt last,
+                      std::vector<typename std::iterator_traits<RandomIt>::value_type>& scratch,
+                      Compare comp = Compare()) {
+      const std::size_t size = static_cast<std::size_t>(last - first);
+      const std::size_t jobs = looper.getMaxThreads();
+      if (size < detail::PARALLEL_THRESHOLD || jobs <= 1) {
+        std::stable_sort(first, last, comp);
+        return;
+      }
+      scratch.resize(size);
+
+      std::vector<std::size_t> runs(jobs + 1);
+      for (std::size_t id = 0; id <= jobs; ++id) {
+        runs[id] = detail::chunkBegin(size, id, jobs);
+      }
+      looper.execute([&](const std::size_t id, const std::size_t) {
+        std::stable_sort(first + runs[id], first + runs[id + 1], comp);
+      }, jobs);
+
+      // Merge a[a, b) with [b, end) into output positions [a + k0, a + k1)
+      struct Piece {
+          std::size_t a, b, end, k0, k1;
+      };
+      std::vector<Piece> pieces;
+      std::vector<std::size_t> merged;
+      bool inScratch = false;
+
+      auto mergePiece = [&comp](const Piece& piece, auto src, auto dst) {
+        const std::size_t m = piece.b - piece.a;
+        const std::size_t n = piece.end - piece.b;
+        const std::size_t i0 = detail::coRank(piece.k0, src + piece.a, m, src + piece.b, n, comp);
+        const std::size_t i1 = detail::coRank(piece.k1, src + piece.a, m, src + piece.b, n, comp);
+        detail::moveMerge(src + piece.a + i0, src + piece.a + i1,
+                          src + piece.b + (piece.k0 - i0), src + piece.b + (piece.k1 - i1),
+                          dst + piece.a + piece.k0, comp);
+      };
+
+      while (runs.size() > 2) {
+        const std::size_t runCount = runs.size() - 1;
+        pieces.clear();
+        merged.clear();
+        for (std::size_t r = 0; r < runCount; r += 2) {
+          const std::size_t a = runs[r];
+          const std::size_t b = runs[r + 1];
+          const std::size_t end = r + 2 <= runCount ? runs[r + 2] : b;
+          merged.push_back(a);
+          // About size / jobs elements per piece so every worker gets a share
+          const std::size_t count = end - a;
+          const std::size_t splits = std::max<std::size_t>(1, (count * jobs + size - 1) / size);
+          for (std::size_t s = 0; s < splits; ++s) {
+            pieces.push_back(Piece { a, b, end, count * s / splits, count * (s + 1) / splits });
+          }
+        }
+        merged.push_back(size);
+
+        looper.parallelFor(0, pieces.size(), [&](const std::size_t begin, const std::size_t end) {
+          for (std::size_t p = begin; p < end; ++p) {
+            if (inScratch) {
+              mergePiece(pieces[p], scratch.begin(), first);
+            } else {
+              mergePiece(pieces[p], first, scratch.begin());
+            }
+          }
+        });
+
+        runs.swap(merged);
+        inScratch = !inScratch;
+      }
+
+      if (inScratch) {
+        looper.parallelFor(0, size, [&](const std::size_t begin, const std::size_t end) {
+          std::move(scratch.begin() + begin, scratch.begin() + end, first + begin);
+        });
+      }
+    }
+
+  template<typename RandomIt, typename Compare = std::less<>>
+    void parallelSort(ParaLooper& looper, RandomIt first, RandomIt last, Compare comp = Compare()) {
+      std::vector<typename std::iterator_traits<RandomIt>::value_type> scratch;
+      parallelSort(looper, first, last, scratch, comp);
+    }
+
+  /**
+   * @brief Stable parallel LSD radix sort of integers or floating point
+   * values, one byte per pass. Passes where every key shares the same
+   * byte are skipped. Negative zero sorts before zero, NaNs sort by bits.
+   *
+   * @param scratch temporary storage, resized to the range size and reusable
+   */
+  template<typename RandomIt, typename T = typename std::iterator_traits<RandomIt>::value_type>
+    std::enable_if_t<detail::IS_RADIX_SORTABLE<T>>
+    parallelRadixSort(ParaLooper& looper, RandomIt first, RandomIt last, std::vector<T>& scratch) {
+      using Counts = std::array<std::size_t, 256>;
+      const std::size_t size = static_cast<std::size_t>(last - first);
+      if (size < 256) {
+        std::stable_sort(first, last, [](const T a, const T b) {
+          return detail::radixKey(a) < detail::radixKey(b);
+        });
+        return;
+      }
+      const std::size_t jobs = size < detail::PARALLEL_THRESHOLD ? 1 : std::max<std::size_t>(1, looper.getMaxThreads());
+      scratch.resize(size);
+      std::vector<Counts> counts(jobs);
+      bool inScratch = false;
+
+      auto forJobs = [&](auto func) {
+        if (jobs == 1) {
+          func(0, 1);
+        } else {
+          looper.execute(func, jobs);
+        }
+      };
+
+      for (std::size_t pass = 0; pass < sizeof(T); ++pass) {
+        const int shift = static_cast<int>(pass * 8);
+
+        forJobs([&](const std::size_t id, const std::size_t) {
+          Counts& c = counts[id];
+          c.fill(0);
+          const std::size_t end = detail::chunkBegin(size, id + 1, jobs);
+          for (std::size_t i = detail::chunkBegin(size, id, jobs); i < end; ++i) {
+            const T value = inScratch ? scratch[i] : first[i];
+            ++c[(detail::radixKey(value) >> shift) & 0xff];
+          }
+        });
+
+        // Digit major, job minor offsets keep the sort stable
+        std::size_t offset = 0;
+        bool skip = false;
+        for (std::size_t digit = 0; digit < 256 && !skip; ++digit) {
+          std::size_t total = 0;
+          for (std::size_t id = 0; id < jobs; ++id) {
+            const std::size_t count = counts[id][digit];
+            counts[id][digit] = offset + total;
+            total += count;
+          }
+          skip = total == size;
+          offset += total;
+        }
+        if (skip) {
+          continue;
+        }
+
+        forJobs([&](const std::size_t id, const std::size_t) {
+          Counts& c = counts[id];
+          const std::size_t end = detail::chunkBegin(size, id + 1, jobs);
+          for (std::size_t i = detail::chunkBegin(size, id, jobs); i < end; ++i) {
+            if (inScratch) {
+              const T value = scratch[i];
+              first[c[(detail::radixKey(value) >> shift) & 0xff]++] = value;
+            } else {
+              const T value = first[i];
+              scratch[c[(detail::radixKey(value) >> shift) & 0xff]++] = value;
+            }
+          }
+        });
+        inScratch = !inScratch;
+      }
+
+      if (inScratch) {
+        forJobs([&](const std::size_t id, const std::size_t) {
+          std::copy(scratch.begin() + detail::chunkBegin(size, id, jobs),
+                    scratch.begin() + detail::chunkBegin(size, id + 1, jobs),
+                    first + detail::chunkBegin(size, id, jobs));
+        });
+      }
+    }
+
+  template<typename RandomIt, typename T = typename std::iterator_traits<RandomIt>::value_type>
+    std::enable_if_t<detail::IS_RADIX_SORTABLE<T>>
+    parallelRadixSort(ParaLooper& looper, RandomIt first, RandomIt last) {
+      std::vector<T> scratch;
+      parallelRadixSort(looper, first, last, scratch);
+    }
+
+  /**
+   * @brief Stable parallel partition
+   *
+   * @param scratch temporary storage, resized to the range size and reusable
+   * @return first element for which pred is false
+   */
+  template<typename RandomIt, typename Predicate>
+    RandomIt parallelPartition(ParaLooper& looper, RandomIt first, RandomIt last, Predicate pred,
+                               std::vector<typename std::iterator_traits<RandomIt>::value_type>& scratch) {
+      const std::size_t size = static_cast<std::size_t>(last - first);
+      const std::size_t jobs = looper.getMaxThreads();
+      if (size < detail::PARALLEL_THRESHOLD || jobs <= 1) {
+        return std::stable_partition(first, last, pred);
+      }
+      scratch.resize(size);
+
+      std::vector<std::size_t> trues(jobs);
+      looper.execute([&](const std::size_t id, const std::size_t) {
+        trues[id] = static_cast<std::size_t>(std::count_if(first + detail::chunkBegin(size, id, jobs),
+                                                           first + detail::chunkBegin(size, id + 1, jobs), pred));
+      }, jobs);
+
+      std::size_t totalTrue = 0;
+      for (auto t : trues) {
+        totalTrue += t;
+      }
+
+      looper.execute([&](const std::size_t id, const std::size_t) {
+        const std::size_t begin = detail::chunkBegin(size, id, jobs);
+        std::size_t t = 0;
+        for (std::size_t j = 0; j < id; ++j) {
+          t += trues[j];
+        }
+        std::size_t f = totalTrue + begin - t;
+        const std::size_t end = detail::chunkBegin(size, id + 1, jobs);
+        for (std::size_t i = begin; i < end; ++i) {
+          scratch[pred(first[i]) ? t++ : f++] = std::move(first[i]);
+        }
+      }, jobs);
+
+      looper.parallelFor(0, size, [&](const std::size_t begin, const std::size_t end) {
+        std::move(scratch.begin() + begin, scratch.begin() + end, first + begin);
+      });
+      return first + totalTrue;
+    }
+
+  template<typename RandomIt, typename Predicate>
+    RandomIt parallelPartition(ParaLooper& looper, RandomIt first, RandomIt last, Predicate pred) {
+      std::vector<typename std::iterator_traits<RandomIt>::value_type> scratch;
+      return parallelPartition(looper, first, last, pred, scratch);
+    }
+
+  /**
+   * @brief Count elements per bin in parallel, counts must be sized to the
+   * number of bins and binOf must return an index below it
+   *
+   * @param scratch per worker counts, resized as needed and reusable
+   */
+  template<typename RandomIt, typename BinOf>
+    void parallelHistogram(ParaLooper& looper, RandomIt first, RandomIt last, BinOf binOf,
+                           std::vector<std::size_t>& counts, std::vector<std::size_t>& scratch) {
+      const std::size_t size = static_cast<std::size_t>(last - first);
+      const std::size_t bins = counts.size();
+      const std::size_t jobs = looper.getMaxThreads();
+      std::fill(counts.begin(), counts.end(), 0);
+      if (size < detail::PARALLEL_THRESHOLD || jobs <= 1) {
+        for (auto it = first; it != last; ++it) {
+          ++counts[binOf(*it)];
+        }
+        return;
+      }
+      scratch.assign(bins * jobs, 0);
+
+      looper.execute([&](const std::size_t id, const std::size_t) {
+        std::size_t* local = scratch.data() + id * bins;
+        const std::size_t end = detail::chunkBegin(size, id + 1, jobs);
+        for (std::size_t i = detail::chunkBegin(size, id, jobs); i < end; ++i) {
+          ++local[binOf(first[i])];
+        }
+      }, jobs);
+
+      looper.parallelFor(0, bins, [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t id = 0; id < jobs; ++id) {
+          const std::size_t* local = scratch.data() + id * bins;
+          for (std::size_t b = begin; b < end; ++b) {
+            counts[b] += local[b];
+          }
+        }
+      });
+    }
+
+  template<typename RandomIt, typename BinOf>
+    void parallelHistogram(ParaLooper& looper, RandomIt first, RandomIt last, BinOf binOf, std::vector<std::size_t>& counts) {
+      std::vector<std::size_t> scratch;
+      parallelHistogram(looper, first, last, binOf, counts, scratch);
+    }
+
+}
+
+#endif /* PARAALGORITHMS_HPP_ */
@@ -1,28 +1,104 @@
 #ifndef PARALOOPER_HPP_
 #define PARALOOPER_HPP_
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
+
+#include "Clock.hpp"
+
+#ifdef UTL_PROFILE
+#include "Profiler.hpp"
+#elif !defined(UTL_PROFILE_SCOPE)
+#define UTL_PROFILE_SCOPE(name)
+#endif
 
 namespace utl {
 
   class ParaLooper {
     public:
 
+      /**
+       * @brief Dispatch lanes. Lanes are served in proportion to their weight
+       * so that lower lanes still progress while higher ones are saturated.
+       */
+      enum class Priority { High, Normal, Background };
+
+      using Deadline = std::chrono::steady_clock::time_point;
+
+      /**
+       * @brief Per worker counters, times in nano seconds
+       *
+       */
+      struct WorkerMetrics {
+          std::uint64_t tasks;
+          double busyNs;
+          double idleNs;
+          double queueLatencyNs;
+          double maxQueueLatencyNs;
+
+          double utilization() const {
+            return busyNs + idleNs > 0. ? busyNs / (busyNs + idleNs) : 0.;
+          }
+      };
+
+      /**
+       * @brief Pool snapshot. tasks and the queue latencies, enqueue to start
+       * time, cover every task including those run by waiting threads, which
+       * are also reported apart in helpers. busyNs and idleNs cover workers only.
+       */
+      struct Metrics {
+          std::size_t awaitingTasks;
+          std::size_t runningTasks;
+          std::uint64_t tasks;
+          double busyNs;
+          double idleNs;
+          double queueLatencyNs;
+          double maxQueueLatencyNs;
+          std::uint64_t helpedTasks;
+          WorkerMetrics helpers;
+          std::vector<WorkerMetrics> workers;
+
+          double utilization() const {
+            return busyNs + idleNs > 0. ? busyNs / (busyNs + idleNs) : 0.;
+          }
+
+          double averageQueueLatencyNs() const {
+            return tasks > 0 ? queueLatencyNs / static_cast<double>(tasks) : 0.;
+          }
+      };
+
+#ifdef UTL_PARALOOPER_METRICS
+      static constexpr bool METRICS = true;
+#else
+      static constexpr bool METRICS = false;
+#endif
+
       ParaLooper(const std::size_t maxWorker = std::thread::hardware_concurrency())
         : mMaxThreads(maxWorker)
         , mTotalTasks(0)
+        , mAwaitingTasks(0)
         , mRunning(false)
         , mPaused(false)
-        , mWaiting(false)
+        , mWaiters(0)
         , mTaskAvailableCv{}
         , mTaskDoneCv{}
         , mTasksMutex {}
+        , mPass(0)
+        , mDeadlineTasks(0)
       {
+        for (std::size_t i = 0; i < PRIORITIES; ++i) {
+          mLanes[i].pass = 0;
+          mLanes[i].stride = STRIDES[i];
+        }
         createThreads();
       }
 
@@ -31,40 +107,105 @@ namespace utl {
         destroyThreads();
       }
 
-      void execute(std::function<void(std::size_t, std::size_t)> task, const std::size_t jobCounts = 0, const bool awaitTasks = true) {
+      /**
+       * @brief Run task(id, jobs) for every id in [0, jobs). When awaited, only
+       * these jobs are waited for and the calling thread runs queued tasks
+       * meanwhile, so it is safe to call from inside a task. A task that
+       * throws terminates the program, on workers and waiting threads alike.
+       *
+       */
+      void execute(std::function<void(std::size_t, std::size_t)> task, const std::size_t jobCounts = 0, const bool awaitTasks = true,
+                   const Priority priority = Priority::Normal) {
         const std::size_t jobs = (jobCounts == 0 || jobCounts > mMaxThreads) ? mMaxThreads : jobCounts;
+        if (!awaitTasks) {
+          for (std::size_t id = 0; id < jobs; ++id) {
+            addTask(priority, NO_DEADLINE, task, id, jobs);
+          }
+          return;
+        }
+
+        std::atomic<std::size_t> remaining(jobs);
         for (std::size_t id = 0; id < jobs; ++id) {
-          addTask(task, id, jobs);
+          addTask(priority, NO_DEADLINE, [&task, &remaining, id, jobs] {
+            task(id, jobs);
+            --remaining;
+          });
         }
+        helpUntil([&remaining] {
+          return remaining == 0;
+        });
+      }
 
-        if(awaitTasks) {
-          waitTasks();
+      /**
+       * @brief Split [first, last) in contiguous ranges and run body(begin, end)
+       * on each of them, nested calls are safe
+       *
+       */
+      void parallelFor(const std::size_t first, const std::size_t last, std::function<void(std::size_t, std::size_t)> body,
+                       const std::size_t jobCounts = 0, const Priority priority = Priority::Normal) {
+        if (first >= last) {
+          return;
         }
+        const std::size_t size = last - first;
+        const std::size_t jobs = std::min(size, (jobCounts == 0 || jobCounts > mMaxThreads) ? mMaxThreads : jobCounts);
+        if (jobs <= 1) {
+          body(first, last);
+          return;
+        }
+        execute([&body, first, size](const std::size_t id, const std::size_t jobs) {
+          body(first + size * id / jobs, first + size * (id + 1) / jobs);
+        }, jobs, true, priority);
       }
 
+      /**
+       * @brief Queue a single task
+       *
+       */
+      void post(std::function<void()> task, const Priority priority = Priority::Normal) {
+        addTask(priority, NO_DEADLINE, task);
+      }
+
+      /**
+       * @brief Queue a single task with a deadline. Within its lane it runs
+       * before tasks without deadline, earliest deadline first, and once
+       * overdue it runs before other lanes as long as its lane is at most
+       * one round ahead of them.
+       *
+       */
+      void post(std::function<void()> task, const Deadline deadline, const Priority priority = Priority::Normal) {
+        addTask(priority, deadline, task);
+      }
+
+      /**
+       * @brief Wait for every queued task while running them on the calling
+       * thread. From inside a task, wait on execute() instead, as the
+       * calling task would be waited for too.
+       *
+       */
       void waitTasks() {
-        mWaiting = true;
-        std::unique_lock<std::mutex> tasks_lock(mTasksMutex);
-        mTaskDoneCv.wait(tasks_lock, [this] {
-          return (mTotalTasks == (mPaused ? mTasks.size() : 0));
+        helpUntil([this] {
+          return (mTotalTasks == (mPaused ? mAwaitingTasks.load() : 0));
         });
-        mWaiting = false;
       }
 
       const std::size_t getAwaitingTasks() const {
-        const std::scoped_lock lock(mTasksMutex);
-        return mTasks.size();
+        return mAwaitingTasks;
       }
 
       std::size_t getRunningTasks() const {
-        const std::scoped_lock lock(mTasksMutex);
-        return mTotalTasks - mTasks.size();
+        const std::size_t total = mTotalTasks;
+        const std::size_t awaiting = mAwaitingTasks;
+        return total > awaiting ? total - awaiting : 0;
       }
 
       const size_t getTotalTasks() const {
         return mTotalTasks;
       }
 
+      std::size_t getMaxThreads() const {
+        return mMaxThreads;
+      }
+
       const bool isRunning() {
         return mRunning;
       }
@@ -78,26 +219,142 @@ namespace utl {
       }
 
       void resume() {
-        mPaused = false;
+        {
+          const std::scoped_lock lock(mTasksMutex);
+          mPaused = false;
+        }
+        mTaskAvailableCv.notify_all();
+        mTaskDoneCv.notify_all();
+      }
+
+      /**
+       * @brief Aggregate worker counters without stopping the workers.
+       * Counters are only maintained when built with UTL_PARALOOPER_METRICS.
+       *
+       * @return pool snapshot
+       */
+      Metrics getMetrics() const {
+        Metrics metrics {};
+        metrics.awaitingTasks = getAwaitingTasks();
+        metrics.runningTasks = getRunningTasks();
+        const std::uint64_t now = METRICS ? TscClock::end() : 0;
+        for (auto &slot : mSlots) {
+          WorkerMetrics worker {};
+          worker.tasks = slot.tasks.load(std::memory_order_relaxed);
+          worker.busyNs = TscClock::toNanoSeconds(slot.busyTicks.load(std::memory_order_relaxed));
+          std::uint64_t idleTicks = slot.idleTicks.load(std::memory_order_acquire);
+          // Include the interval the worker is idling in right now
+          const std::uint64_t idleSince = slot.idleSince.load(std::memory_order_relaxed);
+          if (idleSince != 0 && now > idleSince) {
+            idleTicks += now - idleSince;
+          }
+          worker.idleNs = TscClock::toNanoSeconds(idleTicks);
+          worker.queueLatencyNs = TscClock::toNanoSeconds(slot.queueTicks.load(std::memory_order_relaxed));
+          worker.maxQueueLatencyNs = TscClock::toNanoSeconds(slot.maxQueueTicks.load(std::memory_order_relaxed));
+          metrics.tasks += worker.tasks;
+          metrics.busyNs += worker.busyNs;
+          metrics.idleNs += worker.idleNs;
+          metrics.queueLatencyNs += worker.queueLatencyNs;
+          metrics.maxQueueLatencyNs = std::max(metrics.maxQueueLatencyNs, worker.maxQueueLatencyNs);
+          metrics.workers.push_back(worker);
+        }
+        metrics.helpers.tasks = mHelperSlot.tasks.load(std::memory_order_relaxed);
+        metrics.helpers.busyNs = TscClock::toNanoSeconds(mHelperSlot.busyTicks.load(std::memory_order_relaxed));
+        metrics.helpers.queueLatencyNs = TscClock::toNanoSeconds(mHelperSlot.queueTicks.load(std::memory_order_relaxed));
+        metrics.helpers.maxQueueLatencyNs = TscClock::toNanoSeconds(mHelperSlot.maxQueueTicks.load(std::memory_order_relaxed));
+        metrics.helpedTasks = metrics.helpers.tasks;
+        metrics.tasks += metrics.helpers.tasks;
+        metrics.queueLatencyNs += metrics.helpers.queueLatencyNs;
+        metrics.maxQueueLatencyNs = std::max(metrics.maxQueueLatencyNs, metrics.helpers.maxQueueLatencyNs);
+        return metrics;
       }
 
     private:
+      struct Task {
+          std::function<void()> func;
+          std::uint64_t enqueued;
+          Deadline deadline;
+          Priority priority;
+      };
+
+      struct LaterDeadline {
+          bool operator()(const Task& a, const Task& b) const {
+            return a.deadline > b.deadline;
+          }
+      };
+
+      // Stride scheduling: a lane advances its pass by its stride when served
+      // and the non empty lane with the lowest pass is served next
+      struct Lane {
+          std::queue<Task> tasks;
+          // Min heap on deadline, managed with std::push_heap / std::pop_heap
+          std::vector<Task> deadlines;
+          std::uint64_t pass;
+          std::uint64_t stride;
+
+          bool empty() const {
+            return tasks.empty() && deadlines.empty();
+          }
+      };
+
+      static constexpr std::size_t PRIORITIES = 3;
+      // High, Normal and Background are served 16:4:1 when all saturated
+      static constexpr std::array<std::uint64_t, PRIORITIES> STRIDES { 1, 4, 16 };
+      static constexpr Deadline NO_DEADLINE = Deadline::max();
+      // How far ahead of the lowest pass a lane may be for its overdue tasks
+      // to jump the other lanes, so that they can't starve them
+      static constexpr std::uint64_t OVERDUE_PASS_CREDIT = STRIDES[PRIORITIES - 1];
+
+      // Written by its worker only, padded so workers don't share cache lines
+      struct alignas(64) WorkerSlot {
+          std::atomic<std::uint64_t> tasks { 0 };
+          std::atomic<std::uint64_t> busyTicks { 0 };
+          std::atomic<std::uint64_t> idleTicks { 0 };
+          std::atomic<std::uint64_t> queueTicks { 0 };
+          std::atomic<std::uint64_t> maxQueueTicks { 0 };
+          // Start of the current idle interval, 0 while running a task
+          std::atomic<std::uint64_t> idleSince { 0 };
+
+          static void add(std::atomic<std::uint64_t>& counter, const std::uint64_t value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+          }
+
+          // Every waiting thread shares one slot, so its counters take atomic updates
+          void addShared(const std::uint64_t busy, const std::uint64_t queued) {
+            tasks.fetch_add(1, std::memory_order_relaxed);
+            busyTicks.fetch_add(busy, std::memory_order_relaxed);
+            queueTicks.fetch_add(queued, std::memory_order_relaxed);
+            std::uint64_t max = maxQueueTicks.load(std::memory_order_relaxed);
+            while (queued > max && !maxQueueTicks.compare_exchange_weak(max, queued, std::memory_order_relaxed)) {
+            }
+          }
+      };
+
       std::size_t mMaxThreads;
       std::atomic<size_t> mTotalTasks;
+      std::atomic<size_t> mAwaitingTasks;
       std::atomic<bool> mRunning;
       std::atomic<bool> mPaused;
-      std::atomic<bool> mWaiting;
+      std::atomic<std::size_t> mWaiters;
       std::condition_variable mTaskAvailableCv;
       std::condition_variable mTaskDoneCv;
       mutable std::mutex mTasksMutex;
       std::vector<std::thread> mThreads;
-      std::queue<std::function<void()>> mTasks;
+      std::array<Lane, PRIORITIES> mLanes;
+      std::uint64_t mPass;
+      std::size_t mDeadlineTasks;
+      std::vector<WorkerSlot> mSlots;
+      WorkerSlot mHelperSlot;
 
 
       void createThreads() {
         mRunning = true;
+        if constexpr (METRICS) {
+          TscClock::calibrate();
+          mSlots = std::vector<WorkerSlot>(mMaxThreads);
+        }
         for (std::size_t i = 0; i < mMaxThreads; ++i) {
-          mThreads.emplace_back(std::thread(&ParaLooper::worker, this));
+          mThreads.emplace_back(std::thread(&ParaLooper::worker, this, i));
         }
       }
 
@@ -110,35 +367,158 @@ namespace utl {
       }
 
       template<typename F, typename ... A>
-        void addTask(const F& task, const A& ... args) {
+        void addTask(const Priority priority, const Deadline deadline, const F& task, const A& ... args) {
+          Task t { {}, METRICS ? TscClock::begin() : 0, deadline, priority };
+          if constexpr (sizeof...(args) == 0)
+            t.func = std::function<void()>(task);
+          else
+            t.func = std::function<void()>([task, args...] {
+              task(args...);
+            });
           {
             const std::scoped_lock lock(mTasksMutex);
-            if constexpr (sizeof...(args) == 0)
-              mTasks.push(std::function<void()>(task));
-            else
-              mTasks.push(std::function<void()>([task, args...] {
-                task(args...);
-              }));
+            Lane& lane = mLanes[static_cast<std::size_t>(priority)];
+            if (lane.empty()) {
+              // A lane coming back must not catch up on the time it was idle
+              lane.pass = std::max(lane.pass, mPass);
+            }
+            if (deadline != NO_DEADLINE) {
+              lane.deadlines.push_back(std::move(t));
+              std::push_heap(lane.deadlines.begin(), lane.deadlines.end(), LaterDeadline());
+              ++mDeadlineTasks;
+            } else {
+              lane.tasks.push(std::move(t));
+            }
+            ++mAwaitingTasks;
           }
           ++mTotalTasks;
           mTaskAvailableCv.notify_one();
+          if (mWaiters > 0) {
+            mTaskDoneCv.notify_all();
+          }
+        }
+
+      template<typename P>
+        void helpUntil(P done) {
+          ++mWaiters;
+          std::unique_lock<std::mutex> lock(mTasksMutex);
+          while (!done()) {
+            if (mAwaitingTasks > 0 && !mPaused) {
+              Task task = popTask();
+              lock.unlock();
+              const std::uint64_t start = METRICS ? TscClock::begin() : 0;
+              runTask(task);
+              if constexpr (METRICS) {
+                const std::uint64_t end = TscClock::end();
+                mHelperSlot.addShared(end - start, start > task.enqueued ? start - task.enqueued : 0);
+              }
+              finishTask(task);
+              lock.lock();
+            } else {
+              mTaskDoneCv.wait(lock);
+            }
+          }
+          --mWaiters;
         }
 
-      void worker() {
+      // Queued jobs of execute() reference its stack, an exception leaving a
+      // waiting thread would leave them dangling
+      void runTask(Task& task) noexcept {
+        UTL_PROFILE_SCOPE("ParaLooper::task");
+        task.func();
+      }
+
+      void finishTask(const Task& task) {
+        --mTotalTasks;
+        if (mWaiters > 0) {
+          // Pairs with the predicate check of helpUntil under the lock
+          { const std::scoped_lock lock(mTasksMutex); }
+          mTaskDoneCv.notify_all();
+        }
+        if (task.priority == Priority::Background) {
+          std::this_thread::yield();
+        }
+      }
+
+      // Called with mTasksMutex held and at least one task queued
+      Task popTask() {
+        Lane* lowest = nullptr;
+        for (auto &lane : mLanes) {
+          if (!lane.empty() && (lowest == nullptr || lane.pass < lowest->pass)) {
+            lowest = &lane;
+          }
+        }
+
+        Lane* selected = lowest;
+        if (mDeadlineTasks > 0) {
+          const Deadline now = std::chrono::steady_clock::now();
+          Lane* overdue = nullptr;
+          for (auto &lane : mLanes) {
+            if (!lane.deadlines.empty() && lane.deadlines.front().deadline <= now
+                && lane.pass < lowest->pass + OVERDUE_PASS_CREDIT
+                && (overdue == nullptr || lane.deadlines.front().deadline < overdue->deadlines.front().deadline)) {
+              overdue = &lane;
+            }
+          }
+          if (overdue != nullptr) {
+            selected = overdue;
+          }
+        }
+        // Overdue tasks are charged like any other, which bounds their share
+        mPass = lowest->pass;
+        selected->pass += selected->stride;
+
+        Task task;
+        if (!selected->deadlines.empty()) {
+          std::pop_heap(selected->deadlines.begin(), selected->deadlines.end(), LaterDeadline());
+          task = std::move(selected->deadlines.back());
+          selected->deadlines.pop_back();
+          --mDeadlineTasks;
+        } else {
+          task = std::move(selected->tasks.front());
+          selected->tasks.pop();
+        }
+        --mAwaitingTasks;
+        return task;
+      }
+
+      void worker(const std::size_t index) {
+        if constexpr (METRICS) {
+          mSlots[index].idleSince.store(TscClock::begin(), std::memory_order_relaxed);
+        }
         while (mRunning) {
-          std::function<void()> task;
+          Task task;
           std::unique_lock<std::mutex> lock(mTasksMutex);
           mTaskAvailableCv.wait(lock, [&] {
-            return !mTasks.empty() || !mRunning;
+            return mAwaitingTasks > 0 || !mRunning;
           });
           if (mRunning && !mPaused) {
-            task = std::move(mTasks.front());
-            mTasks.pop();
+            task = popTask();
             lock.unlock();
-            task();
-            --mTotalTasks;
-            if (mWaiting)
-              mTaskDoneCv.notify_one();
+            const std::uint64_t start = METRICS ? TscClock::begin() : 0;
+            if constexpr (METRICS) {
+              // Close the idle interval before publishing it, so that a
+              // concurrent getMetrics() never counts it twice
+              WorkerSlot& slot = mSlots[index];
+              const std::uint64_t idleSince = slot.idleSince.load(std::memory_order_relaxed);
+              slot.idleSince.store(0, std::memory_order_relaxed);
+              slot.idleTicks.store(slot.idleTicks.load(std::memory_order_relaxed) + (start > idleSince ? start - idleSince : 0),
+                                   std::memory_order_release);
+            }
+            runTask(task);
+            if constexpr (METRICS) {
+              const std::uint64_t end = TscClock::end();
+              const std::uint64_t queued = start > task.enqueued ? start - task.enqueued : 0;
+              WorkerSlot& slot = mSlots[index];
+              WorkerSlot::add(slot.tasks, 1);
+              WorkerSlot::add(slot.busyTicks, end - start);
+              WorkerSlot::add(slot.queueTicks, queued);
+              if (queued > slot.maxQueueTicks.load(std::memory_order_relaxed)) {
+                slot.maxQueueTicks.store(queued, std::memory_order_relaxed);
+              }
+              slot.idleSince.store(end, std::memory_order_relaxed);
+            }
+            finishTask(task);
           }
         }
       }
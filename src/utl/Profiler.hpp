@@ -0,0 +1,420 @@
+#ifndef UTLPROFILER_HPP
+#define UTLPROFILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Clock.hpp"
+
+/*
+Build with -DUTL_PROFILE to enable, the macros expand to nothing otherwise.
+
+void handleRequest() {
+    UTL_PROFILE_SCOPE("handleRequest");
+    ...
+}
+
+utl::Profiler::report();
+utl::Profiler::saveTrace("trace.json");
+*/
+
+#ifdef UTL_PROFILE
+#define UTL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define UTL_PROFILE_CONCAT(a, b) UTL_PROFILE_CONCAT_IMPL(a, b)
+#define UTL_PROFILE_SCOPE(name) \
+  static const utl::ProfileZone UTL_PROFILE_CONCAT(utlProfileZone, __LINE__)(name); \
+  const utl::ProfileScope UTL_PROFILE_CONCAT(utlProfileScope, __LINE__)(UTL_PROFILE_CONCAT(utlProfileZone, __LINE__))
+#else
+#define UTL_PROFILE_SCOPE(name)
+#endif
+
+namespace utl {
+
+  struct ProfileEvent {
+      std::uint32_t zone;
+      std::uint32_t depth;
+      std::uint64_t begin;
+      std::uint64_t end;
+      std::uint64_t self;
+  };
+
+  /**
+   * @brief Single producer / single consumer ring of events owned by one
+   * thread. When full, new events are dropped and counted.
+   */
+  class ProfileBuffer {
+    public:
+      static constexpr std::size_t CAPACITY = 1 << 15;
+      static constexpr std::uint32_t MAX_DEPTH = 128;
+
+      explicit ProfileBuffer(const std::uint32_t threadId)
+        : mThreadId(threadId)
+        , mDepth(0)
+        , mChildTicks{}
+        , mHead(0)
+        , mTail(0)
+        , mDropped(0) {
+      }
+
+      std::uint64_t enter() {
+        if (++mDepth < MAX_DEPTH) {
+          mChildTicks[mDepth] = 0;
+        }
+        return TscClock::begin();
+      }
+
+      void leave(const std::uint32_t zone, const std::uint64_t begin) {
+        const std::uint64_t end = TscClock::end();
+        const std::uint64_t total = end - begin;
+        const std::uint64_t children = mDepth < MAX_DEPTH ? mChildTicks[mDepth] : 0;
+        const std::uint64_t self = total - std::min(total, children);
+        const std::uint32_t depth = mDepth--;
+        if (mDepth < MAX_DEPTH) {
+          mChildTicks[mDepth] += total;
+        }
+
+        const std::uint64_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) >= CAPACITY) {
+          mDropped.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        mEvents[head & (CAPACITY - 1)] = ProfileEvent { zone, depth, begin, end, self };
+        mHead.store(head + 1, std::memory_order_release);
+      }
+
+      template<typename F>
+        void drain(F consume) {
+          const std::uint64_t tail = mTail.load(std::memory_order_relaxed);
+          const std::uint64_t head = mHead.load(std::memory_order_acquire);
+          for (std::uint64_t i = tail; i < head; ++i) {
+            consume(mEvents[i & (CAPACITY - 1)]);
+          }
+          mTail.store(head, std::memory_order_release);
+        }
+
+      std::uint32_t getThreadId() const {
+        return mThreadId;
+      }
+
+      std::uint64_t getDropped() const {
+        return mDropped.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::uint32_t mThreadId;
+      std::uint32_t mDepth;
+      std::array<std::uint64_t, MAX_DEPTH> mChildTicks;
+      std::array<ProfileEvent, CAPACITY> mEvents;
+      alignas(64) std::atomic<std::uint64_t> mHead;
+      alignas(64) std::atomic<std::uint64_t> mTail;
+      std::atomic<std::uint64_t> mDropped;
+  };
+
+  class Profiler {
+    public:
+
+      struct ZoneStats {
+          std::uint32_t thread;
+          std::string name;
+          std::size_t count;
+          double totalNs;
+          double selfNs;
+          double p50Ns;
+          double p90Ns;
+          double p99Ns;
+      };
+
+      /**
+       * @brief Register a zone name, called once per UTL_PROFILE_SCOPE site
+       *
+       * @return zone id
+       */
+      static std::uint32_t registerZone(const std::string& name) {
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+        state.zones.push_back(name);
+        return static_cast<std::uint32_t>(state.zones.size() - 1);
+      }
+
+      /**
+       * @brief Buffer of the calling thread, taken on first use and handed
+       * back for reuse when the thread exits
+       *
+       * @return thread buffer
+       */
+      static ProfileBuffer& threadBuffer() {
+        thread_local const BufferOwner owner { acquireBuffer() };
+        return *owner.buffer;
+      }
+
+      /**
+       * @brief Move the events recorded so far by every thread into the profiler
+       *
+       */
+      static void collect() {
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+        for (auto &buffer : state.buffers) {
+          const std::uint32_t thread = buffer->getThreadId();
+          buffer->drain([&](const ProfileEvent& e) {
+            state.events.emplace_back(thread, e);
+          });
+        }
+        // Buffers of exited threads are empty now and can be reused
+        state.freeBuffers.insert(state.freeBuffers.end(), state.retiredBuffers.begin(), state.retiredBuffers.end());
+        state.retiredBuffers.clear();
+      }
+
+      /**
+       * @brief Collect then aggregate events per thread and zone
+       *
+       * @return stats sorted by thread then total time
+       */
+      static std::vector<ZoneStats> getStats() {
+        collect();
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::vector<const ProfileEvent*>> groups;
+        for (auto &e : state.events) {
+          groups[{ e.first, e.second.zone }].push_back(&e.second);
+        }
+
+        std::vector<ZoneStats> stats;
+        std::vector<std::uint64_t> durations;
+        for (auto &g : groups) {
+          durations.clear();
+          std::uint64_t total = 0;
+          std::uint64_t self = 0;
+          for (auto e : g.second) {
+            durations.push_back(e->end - e->begin);
+            total += e->end - e->begin;
+            self += e->self;
+          }
+          std::sort(durations.begin(), durations.end());
+          stats.push_back(ZoneStats { g.first.first, state.zones[g.first.second], durations.size(),
+                                      TscClock::toNanoSeconds(total), TscClock::toNanoSeconds(self),
+                                      percentile(durations, 50.), percentile(durations, 90.),
+                                      percentile(durations, 99.) });
+        }
+        std::sort(stats.begin(), stats.end(), [](const ZoneStats& a, const ZoneStats& b) {
+          return a.thread != b.thread ? a.thread < b.thread : a.totalNs > b.totalNs;
+        });
+        return stats;
+      }
+
+      static void report(std::ostream& os = std::cout) {
+        const std::vector<ZoneStats> stats = getStats();
+        std::size_t maxStrLength = 4;
+        for (auto &s : stats) {
+          maxStrLength = std::max(maxStrLength, s.name.length());
+        }
+
+        os << std::setw(6) << std::left << "Thread" << "  " << std::setw(maxStrLength) << "Zone"
+            << std::right << std::setw(10) << "Count" << std::setw(14) << "Total µs"
+            << std::setw(14) << "Self µs" << std::setw(12) << "p50 µs" << std::setw(12) << "p90 µs"
+            << std::setw(12) << "p99 µs" << std::endl;
+        for (auto &s : stats) {
+          os << std::setw(6) << std::left << s.thread << "  " << std::setw(maxStrLength) << s.name
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << s.count
+              << std::setw(13) << s.totalNs / 1000. << std::setw(13) << s.selfNs / 1000.
+              << std::setw(11) << s.p50Ns / 1000. << std::setw(11) << s.p90Ns / 1000.
+              << std::setw(11) << s.p99Ns / 1000. << std::endl;
+        }
+
+        const std::uint64_t dropped = getDropped();
+        if (dropped > 0) {
+          os << dropped << " events dropped, collect more often" << std::endl;
+        }
+      }
+
+      /**
+       * @brief Collect then write every event in the Chrome trace event format,
+       * loadable in chrome://tracing or Perfetto
+       *
+       */
+      static void saveTrace(const std::string& filename) {
+        collect();
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+
+        std::uint64_t base = UINT64_MAX;
+        for (auto &e : state.events) {
+          base = std::min(base, e.second.begin);
+        }
+
+        std::ofstream file;
+        file.open(filename);
+        file << "{\"traceEvents\":[";
+        std::size_t idx = 0;
+        for (auto &e : state.events) {
+          file << "{\"name\":\"" << escape(state.zones[e.second.zone]) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+              << e.first << ",\"ts\":" << std::fixed << std::setprecision(3)
+              << TscClock::toNanoSeconds(e.second.begin - base) / 1000. << ",\"dur\":"
+              << TscClock::toNanoSeconds(e.second.end - e.second.begin) / 1000. << "}";
+          if (idx < state.events.size() - 1) {
+            file << ",";
+          }
+          idx++;
+        }
+        file << "],\"displayTimeUnit\":\"ns\"}";
+        file.close();
+      }
+
+      /**
+       * @brief Discard collected and pending events
+       *
+       */
+      static void clear() {
+        collect();
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+        state.events.clear();
+      }
+
+      static std::uint64_t getDropped() {
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+        std::uint64_t dropped = 0;
+        for (auto &buffer : state.buffers) {
+          dropped += buffer->getDropped();
+        }
+        return dropped;
+      }
+
+    private:
+      struct BufferOwner {
+          ProfileBuffer* buffer;
+
+          ~BufferOwner() {
+            releaseBuffer(buffer);
+          }
+      };
+
+      struct State {
+          std::mutex mutex;
+          std::vector<std::string> zones;
+          // Buffers outlive their thread so late events can still be collected,
+          // then go back to the free list once drained
+          std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+          std::vector<ProfileBuffer*> retiredBuffers;
+          std::vector<ProfileBuffer*> freeBuffers;
+          std::vector<std::pair<std::uint32_t, ProfileEvent>> events;
+      };
+
+      static State& getState() {
+        // Never destroyed: thread_local buffer owners of pools that outlive
+        // this function local static still release their buffer at exit
+        static State& state = *new State;
+        return state;
+      }
+
+      static ProfileBuffer* acquireBuffer() {
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+        if (!state.freeBuffers.empty()) {
+          ProfileBuffer* buffer = state.freeBuffers.back();
+          state.freeBuffers.pop_back();
+          return buffer;
+        }
+        state.buffers.push_back(std::make_unique<ProfileBuffer>(static_cast<std::uint32_t>(state.buffers.size())));
+        return state.buffers.back().get();
+      }
+
+      static void releaseBuffer(ProfileBuffer* buffer) {
+        State& state = getState();
+        const std::scoped_lock lock(state.mutex);
+        state.retiredBuffers.push_back(buffer);
+      }
+
+      static std::string escape(const std::string& str) {
+        std::string s;
+        for (const char c : str) {
+          switch (c) {
+            case '"':
+              s += "\\\"";
+              break;
+            case '\\':
+              s += "\\\\";
+              break;
+            case '\n':
+              s += "\\n";
+              break;
+            case '\t':
+              s += "\\t";
+              break;
+            default:
+              if (static_cast<unsigned char>(c) < 0x20) {
+                char code[7];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                s += code;
+              } else {
+                s += c;
+              }
+          }
+        }
+        return s;
+      }
+
+      static double percentile(const std::vector<std::uint64_t>& sorted, const double p) {
+        if (sorted.empty()) {
+          return 0.;
+        }
+        const std::size_t rank = static_cast<std::size_t>(p / 100. * static_cast<double>(sorted.size() - 1) + 0.5);
+        return TscClock::toNanoSeconds(sorted[rank]);
+      }
+  };
+
+  class ProfileZone {
+    public:
+      explicit ProfileZone(const std::string& name)
+        : mId(Profiler::registerZone(name)) {
+      }
+
+      std::uint32_t getId() const {
+        return mId;
+      }
+
+    private:
+      std::uint32_t mId;
+  };
+
+  /**
+   * @brief Records the lifetime of a zone into the calling thread buffer
+   *
+   */
+  class ProfileScope {
+    public:
+      explicit ProfileScope(const ProfileZone& zone)
+        : mBuffer(Profiler::threadBuffer())
+        , mZone(zone.getId())
+        , mBegin(mBuffer.enter()) {
+      }
+
+      ~ProfileScope() {
+        mBuffer.leave(mZone, mBegin);
+      }
+
+      ProfileScope(const ProfileScope&) = delete;
+      ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+      ProfileBuffer& mBuffer;
+      std::uint32_t mZone;
+      std::uint64_t mBegin;
+  };
+
+}
+#endif // UTLPROFILER_HPP
@@ -13,14 +13,21 @@ namespace utl {
 
       public:
         ARandomNumberGenerator()
-            : mGenerator(mRndDevice()) {
+            : mGenerator(std::random_device{}()) {
+        }
+
+        explicit ARandomNumberGenerator(const std::uint32_t seed)
+            : mGenerator(seed) {
         }
 
         virtual ~ARandomNumberGenerator() {
         }
 
+        void seed(const std::uint32_t value) {
+          mGenerator.seed(value);
+        }
+
       protected:
-        std::random_device mRndDevice;
         std::mt19937 mGenerator;
     };
 
@@ -36,6 +43,11 @@ namespace utl {
           , mDist(0, 1) {
         }
 
+        explicit RealNumberGenerator(const std::uint32_t seed)
+          : ARandomNumberGenerator(seed)
+          , mDist(0, 1) {
+        }
+
         ~RealNumberGenerator() {
         }
 
@@ -81,6 +93,11 @@ namespace utl {
           , mDist(0, 1) {
         }
 
+        explicit IntegerNumberGenerator(const std::uint32_t seed)
+          : ARandomNumberGenerator(seed)
+          , mDist(0, 1) {
+        }
+
         ~IntegerNumberGenerator() {
         }
 
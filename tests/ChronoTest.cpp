@@ -0,0 +1,41 @@
+#include <chrono>
+#include <thread>
+
+#include "BinaryTest.hpp"
+#include "Chrono.hpp"
+
+UTL_TEST(chronoMeasuresSleep, true) {
+  utl::Chrono chrono(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  chrono.stop();
+  return chrono.asMilliSeconds() >= 5. && chrono.asMilliSeconds() < 1000.;
+}
+
+UTL_TEST(chronoResumeAccumulates, true) {
+  utl::Chrono chrono(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  chrono.stop();
+  const double first = chrono.asNanoSeconds();
+  chrono.resume();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  chrono.stop();
+  return chrono.asNanoSeconds() >= first + 2e6;
+}
+
+UTL_TEST(tscChronoMeasuresSleep, true) {
+  utl::TscClock::calibrate();
+  utl::TscChrono chrono(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  chrono.stop();
+  // Calibration error stays well below 10%
+  return chrono.asMilliSeconds() >= 4.5 && chrono.asMilliSeconds() < 1000.;
+}
+
+UTL_TEST(chronoStopRecords, true) {
+  utl::Histogram histogram;
+  for (int i = 0; i < 10; ++i) {
+    utl::Chrono chrono(true);
+    chrono.stop(histogram);
+  }
+  return histogram.getTotalCount() == 10;
+}
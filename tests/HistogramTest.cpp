@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "BinaryTest.hpp"
+#include "Histogram.hpp"
+
+namespace {
+
+  bool near(const std::uint64_t value, const std::uint64_t expected) {
+    // Three significant digits
+    const double error = static_cast<double>(value > expected ? value - expected : expected - value);
+    return error <= static_cast<double>(expected) / 1000.;
+  }
+
+}
+
+UTL_TEST(histogramPercentiles, true) {
+  utl::Histogram histogram;
+  for (std::uint64_t v = 1; v <= 100000; ++v) {
+    histogram.record(v);
+  }
+  return histogram.getTotalCount() == 100000
+      && histogram.getMin() == 1
+      && histogram.getMax() == 100000
+      && near(histogram.percentile(50.), 50000)
+      && near(histogram.percentile(99.), 99000)
+      && histogram.percentile(100.) == 100000;
+}
+
+UTL_TEST(histogramMerge, true) {
+  utl::Histogram a;
+  utl::Histogram b;
+  a.record(10, 3);
+  b.record(1000);
+  a.merge(b);
+  return a.getTotalCount() == 4 && a.getMin() == 10 && a.getMax() == 1000 && a.getMean() == 257.5;
+}
+
+UTL_TEST(histogramSerializeRoundTrip, true) {
+  utl::Histogram histogram;
+  for (std::uint64_t v = 0; v < 5000; v += 7) {
+    histogram.record(v * v);
+  }
+  const utl::Histogram copy = utl::Histogram::deserialize(histogram.serialize());
+  return copy.getTotalCount() == histogram.getTotalCount()
+      && copy.getMin() == histogram.getMin()
+      && copy.getMax() == histogram.getMax()
+      && copy.percentile(90.) == histogram.percentile(90.)
+      && copy.serialize() == histogram.serialize();
+}
+
+UTL_TEST(histogramRejectsTruncatedData, true) {
+  utl::Histogram histogram;
+  histogram.record(123456);
+  const std::string data = histogram.serialize();
+  try {
+    utl::Histogram::deserialize(data.substr(0, 3));
+  } catch (const std::invalid_argument&) {
+    return true;
+  }
+  return false;
+}
+
+UTL_TEST(histogramReset, true) {
+  utl::Histogram histogram;
+  histogram.record(42);
+  histogram.reset();
+  return histogram.getTotalCount() == 0 && histogram.getMin() == 0 && histogram.percentile(50.) == 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryTest.hpp"
+#include "ParaLooper.hpp"
+
+// Only built in utl_tests_instrumented, which defines both macros
+
+namespace {
+
+  void spin(const std::chrono::steady_clock::duration duration) {
+    const auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+
+}
+
+#ifdef UTL_PARALOOPER_METRICS
+
+UTL_TEST(metricsCountEveryTask, true) {
+  utl::ParaLooper looper(4);
+  for (int i = 0; i < 100; ++i) {
+    looper.execute([](const std::size_t, const std::size_t) {
+    }, 4);
+  }
+  looper.waitTasks();
+  const utl::ParaLooper::Metrics metrics = looper.getMetrics();
+  std::uint64_t workerTasks = 0;
+  for (auto &w : metrics.workers) {
+    workerTasks += w.tasks;
+  }
+  return metrics.tasks == 400
+      && metrics.helpedTasks == metrics.helpers.tasks
+      && workerTasks + metrics.helpers.tasks == 400
+      && metrics.workers.size() == 4
+      && metrics.averageQueueLatencyNs() > 0.
+      && metrics.maxQueueLatencyNs >= metrics.averageQueueLatencyNs();
+}
+
+UTL_TEST(metricsCountOpenIdleInterval, true) {
+  utl::ParaLooper looper(1);
+  std::atomic<bool> done(false);
+  looper.post([&done] {
+    spin(std::chrono::milliseconds(10));
+    done = true;
+  });
+  // Not waitTasks(), which would run the task on this thread
+  while (!done) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  const double busy = looper.getMetrics().utilization();
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  const utl::ParaLooper::Metrics metrics = looper.getMetrics();
+  // Idle since the task ended, while no other task started
+  return metrics.workers[0].tasks == 1 && busy > 0.5 && metrics.utilization() < 0.5;
+}
+
+#endif
+
+#ifdef UTL_PROFILE
+
+namespace {
+
+  void inner() {
+    UTL_PROFILE_SCOPE("instrumentationInner");
+    spin(std::chrono::milliseconds(1));
+  }
+
+  void outer() {
+    UTL_PROFILE_SCOPE("instrumentationOuter");
+    spin(std::chrono::milliseconds(1));
+    inner();
+  }
+
+  const utl::Profiler::ZoneStats* find(const std::vector<utl::Profiler::ZoneStats>& stats, const std::string& name) {
+    const auto it = std::find_if(stats.begin(), stats.end(), [&name](const utl::Profiler::ZoneStats& s) {
+      return s.name == name;
+    });
+    return it != stats.end() ? &*it : nullptr;
+  }
+
+}
+
+UTL_TEST(profilerCountsAndSelfTime, true) {
+  utl::TscClock::calibrate();
+  utl::Profiler::clear();
+  for (int i = 0; i < 10; ++i) {
+    outer();
+  }
+  const std::vector<utl::Profiler::ZoneStats> stats = utl::Profiler::getStats();
+  const utl::Profiler::ZoneStats* o = find(stats, "instrumentationOuter");
+  const utl::Profiler::ZoneStats* i = find(stats, "instrumentationInner");
+  if (o == nullptr || i == nullptr || o->count != 10 || i->count != 10) {
+    return false;
+  }
+  // Outer self time excludes inner, inner has no child zone
+  const double slack = o->totalNs * 0.05;
+  return std::abs(o->selfNs + i->totalNs - o->totalNs) <= slack
+      && std::abs(i->selfNs - i->totalNs) <= slack
+      && o->selfNs >= 9e6 && i->totalNs >= 9e6;
+}
+
+UTL_TEST(profilerCountsPoolTasks, true) {
+  utl::Profiler::clear();
+  {
+    utl::ParaLooper looper(3);
+    looper.execute([](const std::size_t, const std::size_t) {
+    }, 3);
+  }
+  std::size_t tasks = 0;
+  for (auto &s : utl::Profiler::getStats()) {
+    if (s.name == "ParaLooper::task") {
+      tasks += s.count;
+    }
+  }
+  return tasks == 3;
+}
+
+#endif
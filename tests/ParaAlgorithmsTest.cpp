@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "BinaryTest.hpp"
+#include "ParaAlgorithms.hpp"
+#include "RandomNumberGenerator.hpp"
+
+namespace {
+
+  // Above detail::PARALLEL_THRESHOLD so that the parallel paths run
+  constexpr std::size_t SIZE = 100000;
+
+  utl::ParaLooper& looper() {
+    static utl::ParaLooper pool(4);
+    return pool;
+  }
+
+  template<typename T>
+    std::vector<T> randomIntegers(const std::size_t size, const T min, const T max) {
+      utl::IntegerNumberGenerator<T> rng(12345);
+      std::vector<T> values(size);
+      for (auto &v : values) {
+        v = rng.interval(min, max);
+      }
+      return values;
+    }
+
+}
+
+UTL_TEST(parallelSortIsStable, true) {
+  const std::vector<int> keys = randomIntegers<int>(SIZE, 0, 100);
+  std::vector<std::pair<int, std::size_t>> values(SIZE);
+  for (std::size_t i = 0; i < SIZE; ++i) {
+    values[i] = {keys[i], i};
+  }
+  std::vector<std::pair<int, std::size_t>> expected(values);
+  const auto byKey = [](const std::pair<int, std::size_t>& a, const std::pair<int, std::size_t>& b) {
+    return a.first < b.first;
+  };
+  utl::parallelSort(looper(), values.begin(), values.end(), byKey);
+  std::stable_sort(expected.begin(), expected.end(), byKey);
+  return values == expected;
+}
+
+UTL_TEST(parallelSortDescending, true) {
+  std::vector<std::int64_t> values = randomIntegers<std::int64_t>(SIZE, -1000000, 1000000);
+  std::vector<std::int64_t> expected(values);
+  utl::parallelSort(looper(), values.begin(), values.end(), std::greater<>());
+  std::sort(expected.begin(), expected.end(), std::greater<>());
+  return values == expected;
+}
+
+UTL_TEST(parallelRadixSortSigned, true) {
+  std::vector<std::int32_t> values = randomIntegers<std::int32_t>(SIZE, INT32_MIN, INT32_MAX);
+  std::vector<std::int32_t> expected(values);
+  utl::parallelRadixSort(looper(), values.begin(), values.end());
+  std::sort(expected.begin(), expected.end());
+  return values == expected;
+}
+
+UTL_TEST(parallelRadixSortFloatingPoint, true) {
+  utl::RealNumberGenerator<double> rng(6789);
+  std::vector<double> values(SIZE);
+  for (auto &v : values) {
+    v = rng.interval(-1e6, 1e6);
+  }
+  values[0] = 0.;
+  values[1] = -0.;
+  std::vector<double> expected(values);
+  utl::parallelRadixSort(looper(), values.begin(), values.end());
+  std::sort(expected.begin(), expected.end());
+  return values == expected && std::is_sorted(values.begin(), values.end());
+}
+
+UTL_TEST(parallelRadixSortNegativeZeroFirst, true) {
+  for (const std::size_t size : {std::size_t(8), SIZE}) {
+    std::vector<double> values(size, 0.);
+    for (std::size_t i = 0; i < size; i += 2) {
+      values[i] = -0.;
+    }
+    utl::parallelRadixSort(looper(), values.begin(), values.end());
+    const auto firstPositive = std::find_if(values.begin(), values.end(), [](const double v) {
+      return !std::signbit(v);
+    });
+    if (std::any_of(firstPositive, values.end(), [](const double v) { return std::signbit(v); })) {
+      return false;
+    }
+  }
+  return true;
+}
+
+UTL_TEST(parallelPartitionIsStable, true) {
+  std::vector<int> values = randomIntegers<int>(SIZE, 0, 1000);
+  std::vector<int> expected(values);
+  const auto isEven = [](const int v) {
+    return v % 2 == 0;
+  };
+  const auto middle = utl::parallelPartition(looper(), values.begin(), values.end(), isEven);
+  const auto expectedMiddle = std::stable_partition(expected.begin(), expected.end(), isEven);
+  return values == expected && middle - values.begin() == expectedMiddle - expected.begin();
+}
+
+UTL_TEST(parallelHistogramCounts, true) {
+  const std::vector<int> values = randomIntegers<int>(SIZE, 0, 15);
+  std::vector<std::size_t> counts(16);
+  std::vector<std::size_t> expected(16, 0);
+  utl::parallelHistogram(looper(), values.begin(), values.end(), [](const int v) {
+    return static_cast<std::size_t>(v);
+  }, counts);
+  for (const int v : values) {
+    ++expected[static_cast<std::size_t>(v)];
+  }
+  return counts == expected;
+}
+
+namespace {
+
+  std::vector<std::int64_t> unsortedIntegers(utl::BinaryTest::Generators& g) {
+    std::vector<std::int64_t> values(static_cast<std::size_t>(g.integer.interval(0, 1 << 16)));
+    for (auto &v : values) {
+      v = g.integer.interval(INT64_MIN, INT64_MAX);
+    }
+    return values;
+  }
+
+  bool radixSortMatchesSort(const std::vector<std::int64_t>& values) {
+    std::vector<std::int64_t> sorted(values);
+    std::vector<std::int64_t> expected(values);
+    utl::parallelRadixSort(looper(), sorted.begin(), sorted.end());
+    std::sort(expected.begin(), expected.end());
+    return sorted == expected;
+  }
+
+}
+
+UTL_PROPERTY(parallelRadixSortMatchesSort, unsortedIntegers, radixSortMatchesSort, 50);
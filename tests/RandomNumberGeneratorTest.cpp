@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "BinaryTest.hpp"
+#include "RandomNumberGenerator.hpp"
+
+UTL_TEST(rngSeedReplays, true) {
+  utl::IntegerNumberGenerator<std::int64_t> a(42);
+  utl::IntegerNumberGenerator<std::int64_t> b(7);
+  b.seed(42);
+  for (int i = 0; i < 1000; ++i) {
+    if (a.interval(-1000, 1000) != b.interval(-1000, 1000)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+UTL_TEST(rngCopyContinuesSequence, true) {
+  utl::RealNumberGenerator<double> a(1);
+  a.number();
+  utl::RealNumberGenerator<double> b(a);
+  for (int i = 0; i < 1000; ++i) {
+    if (a.number() != b.number()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+UTL_TEST(rngIntervalBounds, true) {
+  utl::IntegerNumberGenerator<int> integer(3);
+  utl::RealNumberGenerator<float> real(3);
+  for (int i = 0; i < 10000; ++i) {
+    const int n = integer.interval(-5, 5);
+    const float r = real.interval(-1.f, 1.f);
+    if (n < -5 || n > 5 || r < -1.f || r > 1.f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+
+  // Bounds then seed, drawn over the whole int64 range
+  std::vector<std::int64_t> boundsAndSeed(utl::BinaryTest::Generators& g) {
+    return { g.integer.interval(INT64_MIN, INT64_MAX), g.integer.interval(INT64_MIN, INT64_MAX),
+             g.integer.interval(0, UINT32_MAX) };
+  }
+
+  bool intervalStaysInBounds(const std::vector<std::int64_t>& input) {
+    if (input.size() != 3) {
+      return true;
+    }
+    const std::int64_t min = std::min(input[0], input[1]);
+    const std::int64_t max = std::max(input[0], input[1]);
+    utl::IntegerNumberGenerator<std::int64_t> integer(static_cast<std::uint32_t>(input[2]));
+    utl::RealNumberGenerator<double> real(static_cast<std::uint32_t>(input[2]));
+    for (int i = 0; i < 100; ++i) {
+      const std::int64_t n = integer.interval(min, max);
+      const double r = real.interval(static_cast<double>(min), static_cast<double>(max));
+      if (n < min || n > max || r < static_cast<double>(min) || r > static_cast<double>(max)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}
+
+UTL_PROPERTY(rngIntervalStaysInBounds, boundsAndSeed, intervalStaysInBounds, 1000);
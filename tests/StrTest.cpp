@@ -0,0 +1,70 @@
+#include <string>
+#include <vector>
+
+#include "BinaryTest.hpp"
+#include "Str.hpp"
+
+UTL_TEST(strTrim, true) {
+  return utl::lTrim(" \t a b \n") == "a b \n"
+      && utl::rTrim(" \t a b \n") == " \t a b"
+      && utl::trim(" \t a b \n") == "a b"
+      && utl::trim("   ").empty()
+      && utl::trim("").empty();
+}
+
+UTL_TEST(strCase, true) {
+  return utl::toLower("HeLLo 42") == "hello 42"
+      && utl::toUpper("HeLLo 42") == "HELLO 42"
+      && utl::capitalize("hello") == "Hello"
+      && utl::equalsIgnoreCase("Utl", "uTL")
+      && !utl::equalsIgnoreCase("utl", "utl ");
+}
+
+UTL_TEST(strSplit, true) {
+  std::vector<std::string> parts;
+  utl::split("a,,b,", ',', parts);
+  return parts == std::vector<std::string>{"a", "", "b", ""};
+}
+
+UTL_TEST(strSplitWithoutDelimiter, true) {
+  std::vector<std::string> parts;
+  utl::split("abc", ',', parts);
+  return parts == std::vector<std::string>{"abc"};
+}
+
+namespace {
+
+  std::string printable(utl::BinaryTest::Generators& g) {
+    std::string s(static_cast<std::size_t>(g.integer.interval(0, 32)), ' ');
+    for (auto &c : s) {
+      c = static_cast<char>(g.integer.interval(9, 126));
+    }
+    return s;
+  }
+
+  std::string commaSeparated(utl::BinaryTest::Generators& g) {
+    std::string s(static_cast<std::size_t>(g.integer.interval(0, 64)), ' ');
+    for (auto &c : s) {
+      c = g.integer.interval(0, 3) == 0 ? ',' : static_cast<char>(g.integer.interval('a', 'z'));
+    }
+    return s;
+  }
+
+  bool trimIsIdempotent(const std::string& s) {
+    return utl::trim(utl::trim(s)) == utl::trim(s);
+  }
+
+  bool splitThenJoinIsIdentity(const std::string& s) {
+    std::vector<std::string> parts;
+    utl::split(s, ',', parts);
+    std::string joined;
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+      joined += (i > 0 ? "," : "") + parts[i];
+    }
+    return joined == s;
+  }
+
+}
+
+UTL_PROPERTY(strTrimIsIdempotent, printable, trimIsIdempotent, 10000);
+UTL_PROPERTY(strSplitThenJoinIsIdentity, commaSeparated, splitThenJoinIsIdentity, 10000);
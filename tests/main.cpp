@@ -0,0 +1,7 @@
+#include "BinaryTest.hpp"
+
+int main() {
+  utl::BinaryTest test("utl tests");
+  test.addRegistered();
+  return test.run(utl::BinaryTest::ShowTest::ALL) ? 0 : 1;
+}